@@ -0,0 +1,107 @@
+#include "poly_autotune.h"
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+    // Estrin daje te same wartości co Horner (dokładnie dla liczb całkowitych;
+    // unsigned liczy modulo 2^64, więc przepełnienie nie szkodzi)
+    template <std::size_t N>
+    void check_estrin() {
+        poly<long long, N> p;
+        poly<unsigned long long, N> u;
+        poly<double, N> q;
+        for (std::size_t i = 0; i < N; ++i) {
+            p[i] = static_cast<long long>(i * 37 % 11) - 5;
+            u[i] = i * 0x9e3779b97f4a7c15ull;
+            q[i] = 1.0 / static_cast<double>(i + 1);
+        }
+        std::size_t saved = poly_tuning::estrin_cutoff;
+        for (long long x = -3; x <= 3; ++x) {
+            // ze znakiem tylko tam, gdzie wynik mieści się w long long
+            bool fits = N <= 17 || (x >= -1 && x <= 1);
+            auto ux = static_cast<unsigned long long>(x);
+            poly_tuning::estrin_cutoff = static_cast<std::size_t>(-1);
+            long long horner = fits ? p.at(x) : 0;
+            unsigned long long horner_u = u.at(ux);
+            double horner_d = q.at(0.9 * static_cast<double>(x));
+            poly_tuning::estrin_cutoff = 0;
+            assert(!fits || p.at(x) == horner);
+            assert(u.at(ux) == horner_u);
+            assert(std::abs(q.at(0.9 * static_cast<double>(x)) - horner_d) <= 1e-12 * (1.0 + std::abs(horner_d)));
+        }
+        poly_tuning::estrin_cutoff = saved;
+    }
+
+    void test_estrin() {
+        check_estrin<2>();
+        check_estrin<3>();
+        check_estrin<5>();
+        check_estrin<17>();
+        check_estrin<64>();
+        check_estrin<100>();
+
+        // zagnieżdżone at() korzysta z Estrina na najgłębszym poziomie
+        poly<poly<int, 20>, 2> nested(poly<int, 20>(1, 2, 3), 1);
+        std::size_t saved = poly_tuning::estrin_cutoff;
+        poly_tuning::estrin_cutoff = 8;
+        assert(nested.at(2, 3) == 2 + 34);
+        poly_tuning::estrin_cutoff = saved;
+
+        // w czasie kompilacji zawsze Horner
+        static_assert(poly<int, 20>(1, 2, 3).at(2) == 17);
+    }
+
+    void test_cache() {
+        std::string path = "autotune_test.cache";
+        poly_tuning_profile profile{40, 24};
+        assert(poly_autotune::save(profile, path));
+        assert(poly_autotune::load(path) == profile);
+
+        // inna wersja albo brakujący próg: plik do ponownego pomiaru
+        {
+            std::ofstream out(path);
+            out << "poly_tuning 0\nkaratsuba_cutoff 40\nestrin_cutoff 24\n";
+        }
+        assert(!poly_autotune::load(path));
+        {
+            std::ofstream out(path);
+            out << poly_autotune::cache_header << "\nkaratsuba_cutoff 40\nbogus line\n";
+        }
+        assert(!poly_autotune::load(path));
+        assert(!poly_autotune::load("autotune_test.missing"));
+
+        // tune() nie mierzy, gdy plik jest
+        poly_tuning_profile saved = poly_tuning_profile::current();
+        poly_autotune::save(profile, path);
+        assert(poly_autotune::tune(path) == profile);
+        assert(poly_tuning::karatsuba_cutoff == 40 && poly_tuning::estrin_cutoff == 24);
+        saved.apply();
+        std::remove(path.c_str());
+    }
+
+    void test_measure() {
+        poly_tuning_profile saved = poly_tuning_profile::current();
+        poly_tuning_profile measured = poly_autotune::measure(1e-4);
+        assert(measured.karatsuba_cutoff >= 7 && measured.karatsuba_cutoff <= 256);
+        assert(measured.estrin_cutoff >= 4);
+        // pomiar nie zmienia bieżących progów
+        assert(poly_tuning_profile::current() == saved);
+
+        // z dowolnymi zmierzonymi progami wyniki są poprawne
+        measured.apply();
+        poly<long long, 300> a(1, 1), b(1, -1);
+        auto c = a * b;
+        assert(c[0] == 1 && c[1] == 0 && c[2] == -1 && c[3] == 0);
+        saved.apply();
+    }
+}
+
+int main() {
+    test_estrin();
+    test_cache();
+    test_measure();
+}
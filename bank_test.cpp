@@ -0,0 +1,111 @@
+#include "poly_bank.h"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace {
+    void test_conversions() {
+        std::vector<poly<float, 8>> polys;
+        for (int k = 0; k < 3000; ++k)
+            polys.push_back(poly<float, 8>(k, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f));
+
+        poly_bank<float, 8> bank(polys);
+        assert(bank.size() == 3000);
+        assert(bank.coefficients(0)[2500] == 2500.0f);
+        assert(bank.coefficients(7)[2500] == 0.5f);
+        assert(bank.get(17)[0] == 17.0f);
+
+        auto back = bank.to_vector();
+        for (int k = 0; k < 3000; ++k)
+            for (int i = 0; i < 8; ++i)
+                assert(back[k][i] == polys[k][i]);
+
+        bank.set(5, poly<float, 8>(1.0f, 2.0f));
+        assert(bank.get(5)[1] == 2.0f && bank.get(5)[7] == 0.0f);
+    }
+
+    void test_evaluate() {
+        std::vector<poly<double, 5>> polys;
+        for (int k = 0; k < 2500; ++k)
+            polys.push_back(poly<double, 5>(k, -1.0, 0.25, 2.0, k % 3));
+        poly_bank<double, 5> bank(polys);
+
+        auto values = bank.evaluate_all(2.0);
+        for (int k = 0; k < 2500; ++k)
+            assert(values[k] == polys[k].at(2.0));
+
+        std::vector<double> xs(2500), out(2500);
+        for (int k = 0; k < 2500; ++k)
+            xs[k] = 0.5 * (k % 7);
+        bank.evaluate_all(xs.data(), out.data());
+        for (int k = 0; k < 2500; ++k)
+            assert(out[k] == polys[k].at(xs[k]));
+    }
+
+    // wartości niedokładne: bank musi zaokrąglać tak samo jak at(), także
+    // przy kompilacji z -march=native, gdzie at() używa FMA (sprawdzać też
+    // z -ffp-contract=off, bo inaczej GCC sam łączy a * b + c w FMA)
+    template <typename T, std::size_t N>
+    void check_evaluate_rounding(std::size_t count) {
+        std::vector<poly<T, N>> polys(count);
+        std::vector<T> xs(count), out(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            for (std::size_t i = 0; i < N; ++i)
+                polys[k][i] = T(1) / static_cast<T>(k + 2 * i + 3);
+            xs[k] = T(1) - T(1) / static_cast<T>(k % 11 + 3);
+        }
+        poly_bank<T, N> bank(polys);
+        bank.evaluate_all(xs.data(), out.data());
+        for (std::size_t k = 0; k < count; ++k)
+            assert(out[k] == polys[k].at(xs[k]));
+        auto values = bank.evaluate_all(xs[1]);
+        for (std::size_t k = 0; k < count; ++k)
+            assert(values[k] == polys[k].at(xs[1]));
+    }
+
+    void test_evaluate_rounding() {
+        check_evaluate_rounding<double, 7>(1000);
+        check_evaluate_rounding<float, 12>(1000);
+        check_evaluate_rounding<double, 1>(10);
+    }
+
+    // współczynniki to ćwiartki liczb całkowitych, więc iloczyny i sumy są
+    // dokładne i wynik nie zależy od kolejności sumowania
+    template <typename T, std::size_t N, typename U, std::size_t M>
+    void check_multiply(std::size_t count) {
+        std::vector<poly<T, N>> xs(count);
+        std::vector<poly<U, M>> ys(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            for (std::size_t i = 0; i < N; ++i)
+                xs[k][i] = static_cast<T>((k + 3 * i) % 17) - T(8);
+            for (std::size_t j = 0; j < M; ++j)
+                ys[k][j] = static_cast<U>((5 * k + j) % 13) / U(4);
+        }
+        poly_bank<T, N> a(xs);
+        poly_bank<U, M> b(ys);
+
+        auto products = multiply_all(a, b);
+        std::vector<decltype(xs[0] * ys[0])> out(count);
+        multiply_all(a, b, out.data());
+        assert(products.size() == count);
+        for (std::size_t k = 0; k < count; ++k) {
+            auto expected = xs[k] * ys[k];
+            for (std::size_t i = 0; i < expected.size(); ++i)
+                assert(products.get(k)[i] == expected[i] && out[k][i] == expected[i]);
+        }
+    }
+
+    void test_multiply() {
+        check_multiply<float, 4, float, 4>(3000);
+        check_multiply<double, 3, double, 5>(64);
+        check_multiply<float, 1, float, 6>(10);
+        check_multiply<int, 4, double, 2>(200);
+    }
+}
+
+int main() {
+    test_conversions();
+    test_evaluate();
+    test_evaluate_rounding();
+    test_multiply();
+}
@@ -1,4 +1,6 @@
 #!/bin/bash
 
 
-clang++ -ferror-limit=1 -Wall -Wextra -std=c++20 -O2 $1.cpp -o poly_test
\ No newline at end of file
+clang++ -ferror-limit=1 -Wall -Wextra -std=c++20 -O2 -pthread $1.cpp -o poly_test
+# g++ z limitem obliczeń w czasie kompilacji takim jak domyślny w clang
+g++ -fmax-errors=1 -Wall -Wextra -std=c++20 -O2 -pthread -fconstexpr-ops-limit=1048576 $1.cpp -o poly_test
\ No newline at end of file
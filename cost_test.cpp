@@ -0,0 +1,97 @@
+#include "poly_cost.h"
+#include <cassert>
+
+namespace {
+    using poly_cost::counted;
+    using poly_cost::counts;
+    using detail::poly_op;
+    using C = counted<long>;
+
+    const poly<C, 3> p(C(1), C(2), C(3));
+    const poly<C, 4> q(C(1), C(1), C(1), C(1));
+
+    void test_multiply() {
+        auto r = poly_cost::measure([] { auto res = p * q; (void)res; });
+        assert((r[poly_op::multiply] == counts{12, 12, 0, 0, 0}));
+        assert(r.total().total() == 24);
+
+        r = poly_cost::measure([] { auto res = p * 2L; (void)res; });
+        assert((r[poly_op::multiply] == counts{3, 0, 0, 0, 3}));
+    }
+
+    void test_at() {
+        const C x(2);
+        auto r = poly_cost::measure([&] { auto res = p.at(x); (void)res; });
+        assert((r[poly_op::at] == counts{2, 2, 0, 0, 0}));
+
+        // wywołania at() dla współczynników liczą się do zewnętrznego at()
+        const poly<poly<C, 2>, 3> n(poly<C, 2>(C(1), C(2)), C(3), C(4));
+        r = poly_cost::measure([&] { auto res = n.at(x, x); (void)res; });
+        assert((r[poly_op::at] == counts{5, 5, 0, 0, 0}));
+        assert(r.total() == r[poly_op::at]);
+    }
+
+    void test_at_planner() {
+        // skalar w zewnętrznej zmiennej i wielomian w wewnętrznej: planer składa
+        // najpierw współczynniki po x i liczy jedno podstawienie y zamiast trzech
+        const poly<poly<C, 4>, 3> n(poly<C, 4>(C(1), C(2), C(3), C(4)), C(3), C(4));
+        const poly<C, 3> y(C(1), C(1), C(1));
+        const C x(2);
+        auto r = poly_cost::measure([&] {
+            auto res = n.at(x, y);
+            assert(res[0] == C(32) && res[6] == C(4));
+        });
+        assert((r[poly_op::at] == counts{35, 35, 0, 0, 0}));
+
+        // odwrotnie opłaca się dotychczasowa kolejność
+        r = poly_cost::measure([&] {
+            auto res = n.at(y, x);
+            assert(res[0] == C(56));
+        });
+        assert((r[poly_op::at] == counts{21, 20, 0, 0, 0}));
+    }
+
+    void test_cross_vs_product() {
+        const poly<poly<C, 2>, 3> n(poly<C, 2>(C(1), C(2)), C(3), C(4));
+        auto product = poly_cost::measure([&] { auto res = n * p; (void)res; });
+        auto crossed = poly_cost::measure([&] { auto res = cross(p, q); (void)res; });
+        assert((product[poly_op::multiply] == counts{18, 18, 0, 0, 0}));
+        assert((crossed[poly_op::cross] == counts{12, 0, 0, 0, 0}));
+        // mnożenia wewnątrz cross() są kosztem cross(), a nie operator*
+        assert(crossed[poly_op::multiply].total() == 0);
+    }
+
+    void test_accumulate() {
+        auto r = poly_cost::measure([] {
+            poly<C, 6> acc;
+            fma_into(acc, p, q);
+        });
+        assert((r[poly_op::fma_into] == counts{12, 12, 0, 0, 0}));
+        assert(r[poly_op::multiply].total() == 0);
+
+        r = poly_cost::measure([] {
+            poly<poly<C, 4>, 3> acc;
+            cross_into(acc, p, q);
+        });
+        assert((r[poly_op::cross_into] == counts{12, 12, 0, 0, 0}));
+        assert(r[poly_op::cross].total() == 0);
+    }
+
+    void test_assign_and_convert() {
+        auto r = poly_cost::measure([] { poly<C, 5> res; res = p; });
+        // wyrazy ponad rozmiar p są zerowane wprost, bez konwersji z int
+        assert(r[poly_op::assign].total() == 0);
+
+        r = poly_cost::measure([] { poly<counted<double>, 5> res(p); (void)res; });
+        assert((r[poly_op::convert] == counts{0, 0, 0, 0, 3}));
+    }
+}
+
+int main() {
+    test_multiply();
+    test_at();
+    test_at_planner();
+    test_cross_vs_product();
+    test_accumulate();
+    test_assign_and_convert();
+}
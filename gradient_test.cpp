@@ -0,0 +1,85 @@
+#include "poly_gradient.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+    using P3 = poly<poly<poly<double, 3>, 4>, 3>;
+
+    // p(x, y, z) = sum c_ijk x^i y^j z^k
+    P3 sample() {
+        P3 p;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                for (std::size_t k = 0; k < 3; ++k)
+                    p[i][j][k] = static_cast<double>((i * 7 + j * 3 + k * 5) % 11) - 5.0;
+        return p;
+    }
+
+    bool close(double a, double b) { return std::fabs(a - b) <= 1e-6 * (1.0 + std::fabs(b)); }
+
+    void test_against_differences() {
+        P3 p = sample();
+        std::array<double, 3> x{0.7, -1.3, 0.4};
+        auto [value, gradient] = at_with_gradient(p, x[0], x[1], x[2]);
+        assert(close(value, p.at(x[0], x[1], x[2])));
+
+        const double h = 1e-5;
+        for (std::size_t i = 0; i < 3; ++i) {
+            auto up = x, down = x;
+            up[i] += h;
+            down[i] -= h;
+            double diff = (p.at(up[0], up[1], up[2]) - p.at(down[0], down[1], down[2])) / (2 * h);
+            assert(close(gradient[i], diff));
+        }
+    }
+
+    void test_exact() {
+        // p(x, y) = 1 + 2y + 3x + 4xy^2
+        poly<poly<int, 3>, 2> p{poly<int, 3>(1, 2), poly<int, 3>(3, 0, 4)};
+        auto d = at_with_gradient(p, 2, 3);
+        assert(d.value == 1 + 6 + 6 + 72);
+        assert(d.gradient[0] == 3 + 4 * 9);
+        assert(d.gradient[1] == 2 + 8 * 2 * 3);
+
+        // jedna zmienna: p'(x)
+        poly<long long, 4> q(5, -1, 0, 2);
+        auto e = at_with_gradient(q, 3LL);
+        assert(e.value == 5 - 3 + 54 && e.gradient[0] == -1 + 54);
+
+        // stała w zmiennej wewnętrznej
+        poly<poly<int, 1>, 2> r{poly<int, 1>(4), poly<int, 1>(7)};
+        auto f = at_with_gradient(r, 2, 9);
+        assert(f.value == 18 && f.gradient[0] == 7 && f.gradient[1] == 0);
+    }
+
+    void test_batch() {
+        P3 p = sample();
+        std::vector<std::array<double, 3>> points;
+        for (int k = 0; k < 2000; ++k)
+            points.push_back({0.001 * k, 1.0 - 0.002 * k, 0.5});
+        std::vector<dual<double, 3>> out(points.size());
+        at_with_gradient(p, points.data(), points.size(), out.data());
+        for (std::size_t k = 0; k < points.size(); ++k) {
+            auto single = at_with_gradient(p, points[k][0], points[k][1], points[k][2]);
+            assert(out[k].value == single.value && out[k].gradient == single.gradient);
+        }
+    }
+
+    // działa też w czasie kompilacji
+    constexpr bool constexpr_gradient() {
+        poly<poly<int, 2>, 2> p{poly<int, 2>(0, 1), poly<int, 2>(1, 1)};   // y + x + xy
+        auto d = at_with_gradient(p, 2, 5);
+        return d.value == 17 && d.gradient[0] == 6 && d.gradient[1] == 3;
+    }
+
+    static_assert(constexpr_gradient());
+}
+
+int main() {
+    test_against_differences();
+    test_exact();
+    test_batch();
+}
@@ -0,0 +1,100 @@
+#define POLY_INSTRUMENT
+#include "poly.h"
+#include <cassert>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using poly_instrument::record;
+
+    const record* find(const std::vector<record>& records, detail::poly_op op, std::size_t n, std::size_t m) {
+        for (const auto& r : records)
+            if (r.site->op == op && r.site->n == n && r.site->m == m)
+                return &r;
+        return nullptr;
+    }
+
+    std::uint64_t histogram_total(const record& r) {
+        std::uint64_t total = 0;
+        for (auto c : r.histogram)
+            total += c;
+        return total;
+    }
+
+    void test_records() {
+        poly<double, 3> p(1.0, 2.0, 3.0);
+        poly<double, 5> q(1.0, 1.0);
+        for (int i = 0; i < 10; ++i) {
+            auto r = p * q;
+            (void)r;
+        }
+        double v = 0;
+        for (int i = 0; i < 7; ++i)
+            v += p.at(0.5);
+        assert(v > 0);
+        poly<poly<int, 2>, 2> nested(poly<int, 2>(1, 1), 2);
+        auto c = cross(nested, poly<int, 3>(1, 2, 3));
+        (void)c;
+        poly<double, 8> acc;
+        for (int i = 0; i < 3; ++i)
+            fma_into(acc, p, poly<double, 4>(1.0, 2.0));
+
+        // w czasie kompilacji nic nie jest mierzone
+        static_assert((poly<int, 2>(1, 1) * poly<int, 2>(1, 1))[1] == 2);
+
+        auto records = poly_instrument::collect();
+        const record* mul = find(records, detail::poly_op::multiply, 3, 5);
+        assert(mul != nullptr && mul->calls == 10 && histogram_total(*mul) == 10);
+        assert(mul->site->depth == 1 && mul->max_ns <= mul->total_ns);
+        assert(mul->signature().find("poly<double, 5") != std::string::npos);
+        assert(std::string(mul->op()) == "operator*");
+
+        const record* at = find(records, detail::poly_op::at, 3, 1);
+        assert(at != nullptr && at->calls == 7);
+
+        const record* crossed = find(records, detail::poly_op::cross, 2, 3);
+        assert(crossed != nullptr && crossed->calls == 1 && crossed->site->depth == 2);
+
+        // akumulacja ma własne rekordy, osobno od operator*
+        const record* fma = find(records, detail::poly_op::fma_into, 3, 4);
+        assert(fma != nullptr && fma->calls == 3 && std::string(fma->op()) == "fma_into");
+        assert(find(records, detail::poly_op::multiply, 3, 4) == nullptr);
+    }
+
+    void test_threads() {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([] {
+                poly<long long, 4> a(1, 2, 3, 4);
+                for (int i = 0; i < 1000; ++i) {
+                    auto b = a * a;
+                    a[0] = b[0] % 7;
+                }
+            });
+        for (auto& t : threads)
+            t.join();
+        // dane zakończonych wątków zostają
+        auto records = poly_instrument::collect();
+        const record* r = find(records, detail::poly_op::multiply, 4, 4);
+        assert(r != nullptr && r->calls == 4000);
+    }
+
+    void test_dump() {
+        std::ostringstream text, json;
+        poly_instrument::dump(text);
+        poly_instrument::dump(json, poly_instrument::format::json);
+        assert(text.str().find("operator* n=3 m=5 depth=1 calls=10") != std::string::npos);
+        assert(json.str().front() == '[' && json.str().find("\"op\": \"at\", \"n\": 3, \"m\": 1") != std::string::npos);
+        assert(json.str().find("\"histogram\": [") != std::string::npos);
+        assert(poly_instrument::dropped() == 0);
+    }
+}
+
+int main() {
+    test_records();
+    test_threads();
+    test_dump();
+}
@@ -0,0 +1,106 @@
+#include "poly_intern.h"
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+    using inner = poly<int, 3>;
+    using P = poly<inner, 4>;
+
+    P make(int k) {
+        return P(inner(k % 7, 1), inner(0, k % 5), 2, inner(k % 3, 0, 1));
+    }
+
+    void test_hash() {
+        std::hash<P> h;
+        assert(h(make(1)) == h(make(1 + 105)));
+        assert(h(make(1)) != h(make(2)));
+        std::hash<poly<double, 2>> hd;
+        assert(hd(poly<double, 2>(0.0, 1.0)) == hd(poly<double, 2>(-0.0, 1.0)));
+    }
+
+    void test_intern() {
+        auto a = intern(make(1));
+        auto b = intern(make(106));
+        auto c = intern(make(2));
+        assert(a == b && !(a == c));
+        assert(&*a == &*b);
+        assert((*c)[1][1] == 2);
+        assert(std::hash<interned<P>>{}(a) == std::hash<interned<P>>{}(b));
+    }
+
+    // wiele wątków internujących nakładające się zbiory
+    void test_concurrent() {
+        using Q = poly<long long, 2>;
+        std::vector<std::thread> threads;
+        std::vector<std::vector<interned<Q>>> handles(4);
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([t, &handles] {
+                for (int k = 0; k < 20000; ++k)
+                    handles[t].push_back(intern(Q(k % 1000 + t, 1)));
+            });
+        for (auto& th : threads)
+            th.join();
+        assert(poly_intern_pool<Q>::instance().size() == 1003);
+        assert(handles[0][5] == handles[1][4]);
+        assert(handles[3][0] == handles[0][3]);
+    }
+
+    void test_memo() {
+        auto a = intern(make(3));
+        auto b = intern(make(4));
+        auto ab = a * b;
+        for (std::size_t i = 0; i < ab->size(); ++i)
+            for (std::size_t j = 0; j < (*ab)[i].size(); ++j)
+                assert((*ab)[i][j] == (make(3) * make(4))[i][j]);
+
+        auto again = intern(make(3 + 105)) * intern(make(4 + 105));
+        assert(again == ab);
+        auto stats = product_memo_stats<P, P>();
+        assert(stats.misses == 1 && stats.hits == 1);
+
+        // zwykłe at() nie zapamiętuje
+        assert(a.at(2, 3) == make(3).at(2, 3));
+        assert((at_memo_stats<P, int, int>().misses == 0));
+
+        int v = a.at_memoized(2, 3);
+        assert(v == make(3).at(2, 3));
+        assert(a.at_memoized(2, 3) == v && b.at_memoized(2, 3) == make(4).at(2, 3));
+        auto at_stats = at_memo_stats<P, int, int>();
+        assert(at_stats.misses == 2 && at_stats.hits == 1);
+        assert((detail::at_memo<P, int, int>::instance().size() == 2));
+        clear_at_memo<P, int, int>();
+        assert((detail::at_memo<P, int, int>::instance().size() == 0));
+
+        auto partial = a.at(2);
+        assert(partial[1] == make(3).at(2)[1]);
+    }
+
+    // tablica wyników nie rośnie ponad pojemność
+    void test_memo_capacity() {
+        using Q = poly<long long, 3>;
+        using memo = detail::at_memo<Q, double>;
+        set_at_memo_capacity<Q, double>(256);
+        auto q = intern(Q(1, 2, 3));
+        for (int k = 0; k < 100000; ++k)
+            assert(q.at_memoized(0.5 * k) == Q(1, 2, 3).at(0.5 * k));
+        assert(memo::instance().size() <= 256);
+
+        auto x = intern(Q(0, 1));
+        for (long long k = 0; k < 3000; ++k)
+            (void)(x * intern(Q(k)));
+        assert((detail::product_memo<Q, Q>::instance().size() > 0));
+        clear_product_memo<Q, Q>();
+        assert((detail::product_memo<Q, Q>::instance().size() == 0));
+    }
+}
+
+int main() {
+    test_hash();
+    test_intern();
+    test_concurrent();
+    test_memo();
+    test_memo_capacity();
+}
@@ -0,0 +1,131 @@
+#include "poly_interpolate.h"
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+    // ciało liczb modulo 998244353, żeby sprawdzać wyniki dokładnie
+    struct mod_p {
+        static constexpr std::uint64_t p = 998244353;
+        std::uint64_t v = 0;
+
+        mod_p() = default;
+        mod_p(long long x) : v(static_cast<std::uint64_t>((x % static_cast<long long>(p) + p) % p)) {}
+
+        friend mod_p operator+(mod_p a, mod_p b) { return raw((a.v + b.v) % p); }
+        friend mod_p operator-(mod_p a, mod_p b) { return raw((a.v + p - b.v) % p); }
+        friend mod_p operator*(mod_p a, mod_p b) { return raw(a.v * b.v % p); }
+        friend mod_p operator/(mod_p a, mod_p b) { return a * b.pow(p - 2); }
+        mod_p operator-() const { return raw((p - v) % p); }
+        mod_p& operator+=(mod_p b) { return *this = *this + b; }
+        mod_p& operator-=(mod_p b) { return *this = *this - b; }
+        friend bool operator==(mod_p a, mod_p b) { return a.v == b.v; }
+
+        mod_p pow(std::uint64_t e) const {
+            mod_p r = 1, b = *this;
+            for (; e; e >>= 1, b = b * b)
+                if (e & 1)
+                    r = r * b;
+            return r;
+        }
+
+        static mod_p raw(std::uint64_t x) {
+            mod_p r;
+            r.v = x;
+            return r;
+        }
+    };
+
+    template <typename T, std::size_t N>
+    T value_at(const poly<T, N>& f, T x) {
+        T acc = T();
+        for (std::size_t i = N; i-- > 0;)
+            acc = acc * x + f[i];
+        return acc;
+    }
+
+    // losowy wielomian, jego wartości w losowych różnych punktach i odtworzenie
+    template <std::size_t N>
+    void check_exact() {
+        std::uint64_t seed = N;
+        auto next = [&] {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<long long>(seed >> 33);
+        };
+        poly<mod_p, N> f;
+        std::array<mod_p, N> xs, ys;
+        for (std::size_t i = 0; i < N; ++i) {
+            f[i] = next();
+            xs[i] = static_cast<long long>(3 * i + 1) + next() % 3;
+        }
+        for (std::size_t i = 0; i < N; ++i)
+            ys[i] = value_at(f, xs[i]);
+
+        auto g = interpolate(xs, ys);
+        for (std::size_t i = 0; i < N; ++i)
+            assert(g[i] == f[i]);
+
+        // ta sama siatka, inne wartości
+        interpolation_grid<mod_p, N> grid(xs);
+        for (std::size_t i = 0; i < N; ++i)
+            f[i] = next();
+        for (std::size_t i = 0; i < N; ++i)
+            ys[i] = value_at(f, xs[i]);
+        g = grid(ys);
+        for (std::size_t i = 0; i < N; ++i)
+            assert(g[i] == f[i]);
+    }
+
+    void test_exact() {
+        check_exact<1>();
+        check_exact<2>();
+        check_exact<17>();
+        check_exact<64>();
+        check_exact<65>();
+        check_exact<300>();
+        check_exact<1000>();
+    }
+
+    void test_chebyshev() {
+        auto grid = interpolation_grid<double, 12>::chebyshev(-1.0, 3.0);
+        poly<double, 12> f(2.0, -1.0, 0.5, 0.0, 0.25);
+        std::array<double, 12> ys;
+        for (std::size_t k = 0; k < 12; ++k) {
+            assert(grid.nodes()[k] > -1.0 && grid.nodes()[k] < 3.0);
+            ys[k] = value_at(f, grid.nodes()[k]);
+        }
+        auto g = grid(ys);
+        for (std::size_t i = 0; i < 12; ++i)
+            assert(std::abs(g[i] - f[i]) < 1e-6);
+    }
+
+    template <std::size_t N>
+    void check_roots_of_unity() {
+        using C = std::complex<double>;
+        auto grid = interpolation_grid<C, N>::roots_of_unity();
+        poly<C, N> f;
+        for (std::size_t i = 0; i < N; ++i)
+            f[i] = C(double(i % 5) - 2.0, double(i % 3));
+        std::array<C, N> ys;
+        for (std::size_t k = 0; k < N; ++k)
+            ys[k] = value_at(f, grid.nodes()[k]);
+        auto g = grid(ys);
+        for (std::size_t i = 0; i < N; ++i)
+            assert(std::abs(g[i] - f[i]) < 1e-9);
+    }
+
+    void test_roots_of_unity() {
+        check_roots_of_unity<1>();
+        check_roots_of_unity<16>();
+        check_roots_of_unity<256>();
+        check_roots_of_unity<12>();
+    }
+}
+
+int main() {
+    test_exact();
+    test_chebyshev();
+    test_roots_of_unity();
+}
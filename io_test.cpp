@@ -0,0 +1,75 @@
+#include "poly_io.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+namespace {
+    const std::string path = "/tmp/poly_io_test.bin";
+
+    void test_roundtrip() {
+        using P = poly<double, 4>;
+        {
+            poly_bank_writer<P> writer(path);
+            for (int i = 0; i < 1000; ++i)
+                writer.write(P(i, 0.5, 0.0, 1.0));
+            writer.close();
+        }
+
+        mapped_poly_bank<P> bank(path);
+        assert(bank.size() == 1000);
+        assert(bank.header().depth == 1 && bank.header().shape[0] == 4);
+        const P& p = bank[123];
+        assert(p[0] == 123.0 && p[1] == 0.5 && p[3] == 1.0);
+        assert(p.at(2.0) == 123.0 + 1.0 + 8.0);
+        // rekordy leżą w zmapowanym pliku, bez kopiowania
+        assert(reinterpret_cast<const std::byte*>(&p) ==
+               reinterpret_cast<const std::byte*>(&bank.header()) + bank.header().data_offset + 123 * sizeof(P));
+    }
+
+    void test_nested() {
+        using P = poly<poly<float, 3>, 2>;
+        {
+            poly_bank_writer<P> writer(path);
+            P rows[2] = {P(poly<float, 3>(1.0f, 2.0f), 3.0f), P(4.0f, poly<float, 3>(5.0f, 0.0f, 6.0f))};
+            writer.write(rows, 2);
+        }
+
+        mapped_poly_bank<P> bank(path);
+        assert(bank.size() == 2);
+        assert(bank.header().depth == 2 && bank.header().shape[0] == 2 && bank.header().shape[1] == 3);
+        assert(bank[1][1][2] == 6.0f);
+        assert(bank[0].at(1.0f, 1.0f) == 6.0f);
+    }
+
+    void test_rejects() {
+        bool thrown = false;
+        try {
+            mapped_poly_bank<poly<double, 3>> wrong_shape(path);
+        } catch (const poly_file_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // obcięty plik
+        {
+            poly_bank_writer<poly<int, 2>> writer(path);
+            writer.write(poly<int, 2>(1, 2));
+            writer.write(poly<int, 2>(3, 4));
+        }
+        assert(::truncate(path.c_str(), 64 + 12) == 0);
+        thrown = false;
+        try {
+            mapped_poly_bank<poly<int, 2>> truncated(path);
+        } catch (const poly_file_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+int main() {
+    test_roundtrip();
+    test_nested();
+    test_rejects();
+    std::remove(path.c_str());
+}
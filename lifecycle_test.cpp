@@ -0,0 +1,102 @@
+#include "poly_trace.h"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+namespace {
+    using X = poly_trace::traced<int>;
+
+    // dokładna liczba kopii (konstrukcje i przypisania kopiujące)
+    // i przeniesień (konstrukcje i przypisania przenoszące) współczynników
+    struct budget {
+        std::size_t copies;
+        std::size_t moves;
+    };
+
+    bool failed = false;
+
+    template <typename F>
+    void check(const char* name, budget b, F&& f) {
+        poly_trace::counts c = poly_trace::measure(std::forward<F>(f));
+        std::size_t copies = c.copies + c.copy_assignments;
+        std::size_t moves = c.moves + c.move_assignments;
+        // mniej niż w budżecie też jest błędem: budżet trzeba wtedy zaostrzyć
+        if (copies != b.copies || moves != b.moves) {
+            std::cerr << name << ": " << copies << " copies, " << moves << " moves (budget "
+                      << b.copies << ", " << b.moves << (copies > b.copies || moves > b.moves ? "" : ", tighten it")
+                      << "); " << c << "\n";
+            failed = true;
+        }
+    }
+
+    void test_traced() {
+        poly_trace::counts c = poly_trace::measure([] {
+            X a(1), b = a, d = std::move(b);
+            a = d;
+            d = std::move(a);
+            X e;
+        });
+        assert(c.value_constructions == 1 && c.copies == 1 && c.moves == 1);
+        assert(c.copy_assignments == 1 && c.move_assignments == 1);
+        assert(c.default_constructions == 1 && c.destructions == 4);
+
+        // measure nie gubi liczników z zewnątrz
+        poly_trace::reset();
+        X a(1);
+        poly_trace::measure([] { X b(2); });
+        assert(poly_trace::snapshot().value_constructions == 1);
+    }
+
+    void test_constructors() {
+        poly<X, 3> p3(1, 2, 3);
+        check("poly<X,5>()", {0, 0}, [] { poly<X, 5> a; });
+        check("poly<X,3>(1, 2, 3)", {0, 3}, [] { poly<X, 3> a(1, 2, 3); });
+        check("poly<X,3>(1)", {0, 0}, [] { poly<X, 3> a(1); });
+        check("poly<X,3>(const poly<X,3>&)", {3, 0}, [&] { poly<X, 3> a(p3); });
+        check("poly<X,5>(const poly<X,3>&)", {3, 0}, [&] { poly<X, 5> a(p3); });
+        check("poly<X,5>(poly<X,3>&&)", {0, 3}, [&] { poly<X, 5> a(std::move(p3)); });
+        check("poly<X,3>(poly<X,3>&&)", {0, 3}, [&] { poly<X, 3> a(std::move(p3)); });
+    }
+
+    void test_assignment() {
+        poly<X, 3> p3(1, 2, 3), q3(4, 5, 6);
+        poly<X, 5> p5;
+        // dwa wyrazy p5 zerowane w miejscu, bez przeniesień
+        check("poly<X,5> = const poly<X,3>&", {3, 0}, [&] { p5 = p3; });
+        check("poly<X,5> = poly<X,3>&&", {0, 3}, [&] { p5 = std::move(p3); });
+        check("poly<X,3> = const poly<X,3>&", {3, 0}, [&] { q3 = p3; });
+        check("poly<X,3> = poly<X,3>&&", {0, 3}, [&] { q3 = std::move(p3); });
+    }
+
+    void test_arithmetic() {
+        poly<X, 3> p3(1, 2, 3), q3(4, 5, 6);
+        check("poly + poly", {0, 3}, [&] { auto r = p3 + q3; });
+        check("poly - poly", {0, 3}, [&] { auto r = p3 - q3; });
+        check("-poly", {0, 3}, [&] { auto r = -p3; });
+        check("poly + X", {3, 1}, [&] { auto r = p3 + X(1); });
+        check("poly * X", {0, 3}, [&] { auto r = p3 * X(2); });
+        check("poly * poly", {0, 9}, [&] { auto r = p3 * q3; });
+        check("poly += poly", {0, 0}, [&] { p3 += q3; });
+        check("poly *= X", {0, 0}, [&] { p3 *= X(2); });
+        check("square(poly)", {0, 11}, [&] { auto r = square(p3); });
+    }
+
+    void test_at_const_poly_cross() {
+        poly<X, 3> p3(1, 2, 3), q3(4, 5, 6);
+        check("poly.at(X)", {1, 0}, [&] { auto r = p3.at(X(2)); });
+        // argument przez wartość: kopie tylko przy jego tworzeniu
+        check("const_poly(const poly&)", {3, 3}, [&] { auto r = const_poly(p3); });
+        check("const_poly(poly&&)", {0, 6}, [&] { auto r = const_poly(std::move(p3)); });
+        check("cross(poly, poly)", {0, 18}, [&] { auto r = cross(p3, q3); });
+    }
+}
+
+int main() {
+    test_traced();
+    test_constructors();
+    test_assignment();
+    test_arithmetic();
+    test_at_const_poly_cross();
+    assert(!failed);
+}
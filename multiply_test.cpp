@@ -0,0 +1,287 @@
+#define POLY_PARALLEL
+#include "poly.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    using poly_storage::heap;
+
+    template <typename P>
+    void fill(P& p, std::uint64_t seed) {
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            if constexpr (detail::is_poly_v<typename P::value_type>)
+                fill(p[i], seed);
+            else
+                p[i] = static_cast<long long>(seed >> 54) - 512;
+        }
+    }
+
+    template <typename A, typename B>
+    bool same(const A& a, const B& b) {
+        if constexpr (detail::is_poly_v<A>) {
+            for (std::size_t i = 0; i < a.size(); ++i)
+                if (!same(a[i], b[i]))
+                    return false;
+            return true;
+        } else
+            return a == b;
+    }
+
+    // porównanie z mnożeniem szkolnym, które wymuszamy wysokim progiem
+    template <std::size_t N, std::size_t M>
+    void check_against_schoolbook() {
+        poly<long long, N, heap> x;
+        poly<int, M, heap> y;
+        fill(x, N);
+        fill(y, M + 7);
+
+        std::size_t cutoff = poly_tuning::karatsuba_cutoff;
+        poly_tuning::karatsuba_cutoff = std::numeric_limits<std::size_t>::max();
+        auto expected = x * y;
+        poly_tuning::karatsuba_cutoff = cutoff;
+        auto fast = x * y;
+        assert(same(fast, expected));
+    }
+
+    void test_karatsuba() {
+        check_against_schoolbook<33, 33>();
+        check_against_schoolbook<100, 100>();
+        check_against_schoolbook<257, 64>();
+        check_against_schoolbook<64, 1000>();
+        check_against_schoolbook<1023, 1025>();
+
+        poly<double, 200> p(1.0, 1.0);
+        poly<double, 200> q(1.0, -1.0);
+        auto r = p * q;
+        assert(r[0] == 1.0 && r[1] == 0.0 && r[2] == -1.0 && r[3] == 0.0);
+    }
+
+    void test_square() {
+        poly<long long, 300, heap> x;
+        fill(x, 3);
+        std::size_t cutoff = poly_tuning::karatsuba_cutoff;
+        poly_tuning::karatsuba_cutoff = std::numeric_limits<std::size_t>::max();
+        auto expected = x * x;
+        assert(same(square(x), expected));
+        poly_tuning::karatsuba_cutoff = cutoff;
+        assert(same(square(x), expected));
+        assert(same(x * x, expected));
+
+        // |y_i| <= 512, więc współczynniki y^4 sięgają 40^3 * 512^4 - poza int
+        poly<long long, 40> y;
+        fill(y, 5);
+        auto p = pow<4>(y);
+        static_assert(p.size() == 157);
+        assert(same(p, square(y * y)));
+        auto t = pow_truncated<100>(y, 4);
+        for (std::size_t i = 0; i < t.size(); ++i)
+            assert(t[i] == p[i]);
+    }
+
+    // iloczyn w czasie kompilacji: (1 + x + ... + x^{N-1})^2 ma współczynniki
+    // 1, 2, ..., N, ..., 2, 1. Rozmiary w static_assert mieszczą się w
+    // domyślnym limicie clang (-fconstexpr-steps=1048576), dużo niższym niż
+    // w GCC; compile_test.sh sprawdza to także pod g++ z takim limitem
+    template <std::size_t N>
+    constexpr bool constexpr_square_of_ones() {
+        poly<long long, N> p;
+        for (std::size_t i = 0; i < N; ++i)
+            p[i] = 1;
+        auto q = p * p;
+        for (std::size_t k = 0; k < q.size(); ++k)
+            if (q[k] != static_cast<long long>(std::min(k + 1, 2 * N - 1 - k)))
+                return false;
+        return true;
+    }
+
+    // rozwinięte iloczyny małych wielomianów zmiennoprzecinkowych
+    template <std::size_t N, std::size_t M>
+    void check_small() {
+        poly<double, N> x;
+        poly<double, M> y;
+        fill(x, N);
+        fill(y, M + 3);
+        poly<double, N + M - 1> expected;
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < M; ++j)
+                expected[i + j] += x[i] * y[j];
+        assert(same(x * y, expected));
+    }
+
+    template <std::size_t N, std::size_t... M>
+    void check_small_row(std::index_sequence<M...>) {
+        (check_small<N, M + 1>(), ...);
+    }
+
+    template <std::size_t... N>
+    void test_small(std::index_sequence<N...>) {
+        (check_small_row<N + 1>(std::make_index_sequence<poly_tuning::unroll_limit>()), ...);
+        check_small<poly_tuning::unroll_limit + 1, 3>();
+
+        constexpr auto p = poly<double, 3>(1.0, 2.0, 3.0) * poly<double, 2>(1.0, -1.0);
+        static_assert(p[0] == 1.0 && p[1] == 1.0 && p[2] == 1.0 && p[3] == -3.0);
+        static_assert(poly<double, 4>(1.0, 2.0, 0.0, 1.0).at(2.0) == 13.0);
+    }
+
+    // wielomiany zagnieżdżone (podstawienie Kroneckera) kontra zagnieżdżone mnożenie szkolne
+    template <typename X, typename Y>
+    void check_nested() {
+        X x;
+        Y y;
+        fill(x, 3);
+        fill(y, 11);
+
+        std::size_t cutoff = poly_tuning::karatsuba_cutoff;
+        poly_tuning::karatsuba_cutoff = std::numeric_limits<std::size_t>::max();
+        auto expected = x * y;
+        poly_tuning::karatsuba_cutoff = cutoff;
+        auto fast = x * y;
+        static_assert(std::is_same_v<decltype(fast), decltype(expected)>);
+        assert(same(fast, expected));
+    }
+
+    void test_kronecker() {
+        check_nested<poly<poly<long long, 8>, 12>, poly<poly<int, 5>, 9>>();
+        check_nested<poly<poly<long long, 40>, 3>, poly<poly<long long, 40>, 3>>();
+        check_nested<poly<poly<poly<long long, 3>, 4>, 5>, poly<poly<poly<int, 3>, 4>, 6>>();
+        // czynniki różnej głębokości
+        check_nested<poly<poly<long long, 6>, 10>, poly<long long, 20>>();
+        check_nested<poly<long long, 20>, poly<poly<long long, 6>, 10>>();
+        check_nested<poly<poly<double, 7>, 7, heap>, poly<poly<double, 7>, 7>>();
+    }
+
+    // (sum x^i y^j, i, j < N)^2: współczynnik przy x^i y^j to c(i) c(j),
+    // gdzie c(k) = min(k, 2N - 2 - k) + 1
+    template <std::size_t N>
+    constexpr bool constexpr_nested_square() {
+        poly<poly<long long, N>, N> p;
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < N; ++j)
+                p[i][j] = 1;
+        auto q = p * p;
+        auto c = [](std::size_t k) { return static_cast<long long>(std::min(k, 2 * N - 2 - k) + 1); };
+        for (std::size_t i = 0; i < 2 * N - 1; ++i)
+            for (std::size_t j = 0; j < 2 * N - 1; ++j)
+                if (q[i][j] != c(i) * c(j))
+                    return false;
+        return true;
+    }
+
+    static_assert(constexpr_nested_square<6>());
+
+    static_assert(constexpr_square_of_ones<10>());
+    static_assert(constexpr_square_of_ones<128>());
+
+    // fma_into powyżej progu Karatsuby daje to samo co acc + p * q
+    void test_fma_into() {
+        poly<double, 200> acc;
+        poly<double, 120> p;
+        poly<double, 80> q;
+        for (std::size_t i = 0; i < 200; ++i)
+            acc[i] = 1.0 / static_cast<double>(i + 1);
+        for (std::size_t i = 0; i < 120; ++i)
+            p[i] = 1.0 / static_cast<double>(i + 3);
+        for (std::size_t i = 0; i < 80; ++i)
+            q[i] = 1.0 - 1.0 / static_cast<double>(i + 2);
+        poly<double, 200> expected = acc + p * q;
+        fma_into(acc, p, q);
+        assert(same(acc, expected));
+    }
+
+    // gałęzie równoległe wykonują te same działania co szeregowe, więc
+    // wynik zmiennoprzecinkowy musi być identyczny bit w bit
+    template <std::size_t N, std::size_t M>
+    void check_parallel_bitwise() {
+        poly<double, N, heap> x;
+        poly<double, M, heap> y;
+        for (std::size_t i = 0; i < N; ++i)
+            x[i] = 1.0 / static_cast<double>(i + 3);
+        for (std::size_t i = 0; i < M; ++i)
+            y[i] = 1.0 - 1.0 / static_cast<double>(2 * i + 7);
+
+        std::size_t cutoff = poly_tuning::parallel_cutoff;
+        poly_tuning::parallel_cutoff = std::numeric_limits<std::size_t>::max();
+        auto serial = x * y;
+        poly_tuning::parallel_cutoff = 64;
+        auto parallel = x * y;
+        poly_tuning::parallel_cutoff = cutoff;
+        assert(std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(double)) == 0);
+    }
+
+    void test_parallel() {
+        // pula z main(), niezależnie od liczby rdzeni maszyny
+        assert(poly_thread_pool::instance().size() == 4);
+        std::size_t cutoff = poly_tuning::parallel_cutoff;
+        poly_tuning::parallel_cutoff = 64;
+        check_against_schoolbook<4096, 4096>();
+        check_against_schoolbook<3000, 1500>();
+        poly_tuning::parallel_cutoff = cutoff;
+        check_parallel_bitwise<4096, 4096>();
+        check_parallel_bitwise<3000, 1500>();
+    }
+
+    // wyjątek z zadania zagnieżdżonego w innym zadaniu wspólnej puli wraca
+    // z zewnętrznego invoke() po zakończeniu wszystkich gałęzi
+    void test_parallel_exception() {
+        auto& pool = poly_thread_pool::instance();
+        std::atomic<int> done{0};
+        bool thrown = false;
+        try {
+            pool.invoke([&] { done.fetch_add(1); },
+                        [&] { pool.invoke([&] { done.fetch_add(1); }, [] { throw std::runtime_error("task"); }); },
+                        [&] { done.fetch_add(1); });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && done.load() == 3);
+        // pula nadal działa
+        check_parallel_bitwise<1024, 1024>();
+    }
+
+    // wyjątek z zadania wraca z wait(), a pozostałe zadania i tak się kończą
+    void test_task_group_exception() {
+        poly_thread_pool pool(2);
+        std::atomic<int> done{0};
+        poly_thread_pool::task_group group(pool);
+        for (int i = 0; i < 8; ++i)
+            group.spawn([&done, i] {
+                if (i == 3)
+                    throw std::runtime_error("task");
+                done.fetch_add(1);
+            });
+        bool thrown = false;
+        try {
+            group.wait();
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && done.load() == 7);
+        // grupa nadaje się do dalszego użytku
+        group.spawn([&done] { done.fetch_add(1); });
+        group.wait();
+        assert(done.load() == 8);
+    }
+}
+
+int main() {
+    // pula co najmniej czterowątkowa, żeby gałąź równoległa działała też
+    // na maszynach z jednym rdzeniem; przed pierwszym mnożeniem
+    poly_thread_pool::instance(4);
+    test_karatsuba();
+    test_square();
+    test_small(std::make_index_sequence<poly_tuning::unroll_limit>());
+    test_kronecker();
+    test_fma_into();
+    test_parallel();
+    test_task_group_exception();
+    test_parallel_exception();
+}
@@ -8,6 +8,11 @@ constexpr bool operator==(const poly<T, N> &a, const poly<T, N> &b) {
     return true;
 }
 
+#ifndef POLY_INSTRUMENT
+// bez POLY_INSTRUMENT obserwator operacji nie ma stanu
+static_assert(std::is_empty_v<detail::op_observer<int>>);
+#endif
+
 int main() {
     // Basic operations with different types
     constexpr auto p1 = poly<int, 3>(3, 2, 1);
@@ -106,4 +111,103 @@ int main() {
 
     static_assert((single_p * nested_double_p)[0] == poly<double, 2>(1.5, 2.5));
     static_assert((nested_p * double_p)[0] == poly<double, 2>(1.5, 3.0));
+
+    // Fused multiply-accumulate tests
+    constexpr auto fma_test = []() {
+        poly<long long, 6> acc(1);
+        fma_into(acc, poly<int, 3>(3, 2, 1), poly<int, 2>(1, 1));
+        fma_into(acc, poly<int, 3>(0, 1), poly<int, 3>(0, 0, 2));
+        return acc;
+    };
+    static_assert(fma_test() == poly<long long, 6>(4, 5, 3, 3, 0, 0));
+
+    constexpr auto nested_fma_test = []() {
+        constexpr auto np = poly<poly<int, 2>, 2>(poly<int, 2>(1, 2), poly<int, 2>(3, 4));
+        poly<poly<int, 3>, 3> acc;
+        fma_into(acc, np, np);
+        fma_into(acc, np, poly<int, 2>(1, 2));
+        return acc;
+    };
+    static_assert(nested_fma_test() == nested_p * nested_p + nested_p * single_p);
+
+    constexpr auto alias_fma_test = []() {
+        poly<int, 3> acc(1, 2, 3);
+        fma_into(acc, acc, poly<int, 1>(2));
+        fma_into(acc, poly<int, 1>(2), acc);
+        return acc;
+    };
+    static_assert(alias_fma_test() == poly<int, 3>(9, 18, 27));
+
+    // above the compile-time Karatsuba cutoff the product goes through a buffer
+    constexpr auto karatsuba_fma_test = []() {
+        poly<int, 20> p;
+        poly<int, 24> q;
+        poly<long long, 43> acc;
+        for (size_t i = 0; i < 20; ++i)
+            p[i] = static_cast<int>(i * 7 % 11) - 5;
+        for (size_t i = 0; i < 24; ++i)
+            q[i] = static_cast<int>(i * 5 % 13) - 6;
+        for (size_t i = 0; i < 43; ++i)
+            acc[i] = static_cast<long long>(i);
+        poly<long long, 43> expected = acc + p * q;
+        fma_into(acc, p, q);
+        return acc == expected;
+    };
+    static_assert(karatsuba_fma_test());
+
+    constexpr auto cross_into_test = []() {
+        poly<poly<double, 2>, 2> acc(poly<double, 2>(1.0), 0.0);
+        cross_into(acc, poly<int, 2>(1, 2), poly<double, 2>(1.5, 2.5));
+        return acc;
+    };
+    static_assert(cross_into_test() == poly<poly<double, 2>, 2>(poly<double, 2>(2.5, 2.5), poly<double, 2>(3.0, 5.0)));
+
+    // Evaluation order planner keeps at() results and types
+    constexpr auto wide = poly<poly<int, 4>, 3>(poly<int, 4>(1, 2, 3, 4), poly<int, 4>(0, 1), 5);
+    static_assert(std::is_same_v<decltype(wide.at(2.0, 3)), double>);
+    static_assert(wide.at(2.0, 3) == 142.0 + 2.0 * 3.0 + 4.0 * 5.0);
+    static_assert(wide.at(2, 3, 100) == wide.at(2, 3));
+    static_assert(wide.at(2, poly<int, 2>(0, 1)) == poly<int, 4>(21, 4, 3, 4));
+    // ...and never folds in a narrower type than the default order uses
+    constexpr auto narrow = poly<poly<short, 2>, 3>(0, 0, poly<short, 2>(200, 1));
+    static_assert(std::is_same_v<decltype(narrow.at(short(20), short(1))), int>);
+    static_assert(narrow.at(short(20), short(1)) == 80400);
+    // ...and for doubles matches the default order only up to rounding
+    // (at 0.9, 0.9 the two orders differ in the last two bits)
+    constexpr auto rounding_test = []() {
+        poly<poly<double, 8>, 3> p;
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t j = 0; j < 8; ++j)
+                p[i][j] = 1.0 / static_cast<double>(i + 2 * j + 3);
+        double x = 0.9, y = 0.9;
+        double inner[3];
+        for (size_t i = 0; i < 3; ++i) {
+            inner[i] = p[i][7];
+            for (size_t j = 7; j-- > 0;)
+                inner[i] = y * inner[i] + p[i][j];
+        }
+        double expected = (inner[2] * x + inner[1]) * x + inner[0];
+        double diff = p.at(x, y) - expected;
+        return (diff < 0 ? -diff : diff) <= 1e-15 * expected;
+    };
+    static_assert(rounding_test());
+
+    // Powers
+    constexpr auto base = poly<int, 3>(1, 2, 3);
+    static_assert(square(base) == base * base);
+    static_assert(std::is_same_v<decltype(pow<5>(base)), poly<int, 11>>);
+    static_assert(pow<5>(base) == base * base * base * base * base);
+    static_assert(pow<0>(base) == poly<int, 1>(1));
+    static_assert(pow<1>(base) == base);
+    static_assert(square(nested_p) == nested_p * nested_p);
+    static_assert(pow<3>(nested_p) == nested_p * nested_p * nested_p);
+    static_assert(pow_truncated<4>(base, 5) == poly<int, 4>(1, 10, 55, 200));
+    static_assert(pow_truncated<11>(base, 5) == pow<5>(base));
+    static_assert(pow_truncated<3>(base, 0) == poly<int, 3>(1));
+
+    // Size compatibility is checked at compile time
+    static_assert(!std::is_invocable_v<decltype([](auto &acc, const auto &p, const auto &q) -> decltype(fma_into(acc, p, q)) {
+                                           return fma_into(acc, p, q);
+                                       }),
+                                       poly<int, 2> &, const poly<int, 2> &, const poly<int, 2> &>);
 }
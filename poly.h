@@ -4,74 +4,261 @@
 #include <cstddef>
 #include <type_traits>
 #include <concepts>
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <functional>
+#include <memory>
+#include <vector>
+
+#include "poly_storage.h"
+#include "poly_multiply.h"
 
 // deklaracja poly
-template <typename T, size_t N> 
+template <typename T, size_t N, typename S> 
 class poly;
 
 
 namespace detail
 {
+    // znacznik konstruktora poly bez zerowania współczynników
+    struct uninitialized_t
+    {
+    };
+    inline constexpr uninitialized_t uninitialized{};
+
     // template do sprawdzania czy typ jest wielomianem
     template <typename U>
     struct is_poly : std::false_type
     {
     };
 
-    template <typename U, size_t M>
-    struct is_poly<poly<U, M>> : std::true_type
+    template <typename U, size_t M, typename S>
+    struct is_poly<poly<U, M, S>> : std::true_type
     {
     };
 
     template <typename U>
     inline constexpr bool is_poly_v = is_poly<U>::value;
+
+    // typ współczynników na najgłębszym poziomie zagnieżdżenia
+    // i liczba poziomów (0 dla typów, które nie są wielomianami)
+    template <typename U>
+    struct poly_scalar
+    {
+        using type = U;
+        static constexpr size_t depth = 0;
+        static constexpr size_t elements = 1;
+    };
+
+    template <typename U, size_t M, typename S>
+    struct poly_scalar<poly<U, M, S>>
+    {
+        using type = typename poly_scalar<U>::type;
+        static constexpr size_t depth = poly_scalar<U>::depth + 1;
+        // liczba skalarów w całym wielomianie
+        static constexpr size_t elements = M * poly_scalar<U>::elements;
+    };
+
+    template <typename U>
+    using poly_scalar_t = typename poly_scalar<U>::type;
+
+    template <typename U>
+    inline constexpr size_t poly_depth_v = poly_scalar<U>::depth;
+
+    // operacje wielomianów, którym można przypisywać koszt
+    enum class poly_op
+    {
+        multiply,
+        at,
+        cross,
+        assign,
+        convert,
+        fma_into,
+        cross_into
+    };
+
+    inline const char *poly_op_name(poly_op op)
+    {
+        constexpr const char *names[] = {"operator*", "at", "cross", "assign", "convert", "fma_into", "cross_into"};
+        return names[static_cast<size_t>(op)];
+    }
+
+    // liczba współczynników na najwyższym poziomie (1 dla typów, które nie są wielomianami)
+    template <typename U>
+    inline constexpr size_t outer_size_v = 1;
+
+    template <typename U, size_t M, typename S>
+    inline constexpr size_t outer_size_v<poly<U, M, S>> = M;
+
+    // typy argumentów w zapisie kompilatora (__PRETTY_FUNCTION__)
+    template <typename X, typename Y>
+    const char *site_signature()
+    {
+        return __PRETTY_FUNCTION__;
+    }
+
+    // Miejsce operacji: rodzaj, rozmiary obu argumentów i największa głębokość
+    // zagnieżdżenia. Jeden stały obiekt na każdą konkretyzację szablonu.
+    struct op_site
+    {
+        poly_op op;
+        size_t n;
+        size_t m;
+        size_t depth;
+        const char *(*signature)();
+    };
+
+    template <poly_op Op, typename X, typename Y>
+    inline constexpr op_site op_site_v{Op, outer_size_v<X>, outer_size_v<Y>,
+                                       std::max(poly_scalar<X>::depth, poly_scalar<Y>::depth), &site_signature<X, Y>};
 }
 
-template <typename T, size_t N = 0>
+#ifdef POLY_INSTRUMENT
+#include "poly_instrument.h"
+#endif
+
+namespace detail
+{
+    // Obserwator operacji tworzony na czas jej trwania. Domyślnie pusty (przy
+    // POLY_INSTRUMENT mierzy czas, zob. poly_instrument.h), typy
+    // współczynników mogą go specjalizować (zob. poly_cost.h).
+    // POLY_INSTRUMENT zmienia tę definicję, więc musi być ustawione tak samo
+    // we wszystkich jednostkach translacji programu (najlepiej
+    // -DPOLY_INSTRUMENT w opcjach kompilacji) - inaczej to naruszenie ODR,
+    // którego linker nie zgłosi.
+    template <typename Scalar>
+    struct op_observer
+#ifdef POLY_INSTRUMENT
+        : poly_instrument::timer
+#endif
+    {
+#ifdef POLY_INSTRUMENT
+        constexpr explicit op_observer(const op_site &site) : poly_instrument::timer(site) {}
+#else
+        constexpr explicit op_observer(const op_site &) {}
+#endif
+    };
+
+    template <typename P>
+    using op_observer_t = op_observer<poly_scalar_t<P>>;
+
+    // Szacowany koszt at(): liczba działań na skalarach, a przy remisie
+    // długość łańcucha kroków Hornera zależnych od poprzednich.
+    struct eval_cost
+    {
+        size_t ops;
+        size_t chain;
+
+        constexpr bool operator<(const eval_cost &other) const
+        {
+            return ops != other.ops ? ops < other.ops : chain < other.chain;
+        }
+    };
+
+    // łączenie skrótów (jak boost::hash_combine, w wersji 64-bitowej)
+    constexpr size_t hash_mix(size_t seed, size_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    // pierwsze B współczynników p (brakujące są zerami)
+    template <size_t B, typename T, size_t N, typename S>
+    constexpr poly<T, B, S> truncate(const poly<T, N, S> &p)
+    {
+        poly<T, B, S> res;
+        for (size_t i = 0; i < std::min(B, N); ++i)
+            res[i] = p[i];
+        return res;
+    }
+
+    // obiekty innego typu nigdy nie są tym samym obiektem; bez porównania
+    // adresów, którego nie zawsze da się policzyć w czasie kompilacji
+    template <typename X, typename Y>
+    constexpr bool same_object(const X &x, const Y &y)
+    {
+        if constexpr (!std::is_same_v<X, Y>)
+            return false;
+        else
+            return &x == &y;
+    }
+
+    // polityka przechowywania wyniku działania na dwóch wielomianach:
+    // wygrywa polityka różna od domyślnej, a przy remisie lewy argument
+    template <typename S1, typename S2>
+    using common_storage_t = std::conditional_t<std::is_same_v<S1, poly_storage::inline_buffer>, S2, S1>;
+}
+
+template <typename T, size_t N = 0, typename S = poly_storage::inline_buffer>
 class poly
 {
 public:
     // Aby można było swobodnie używać zmiennych prywatnych przy używaniu common_type
-    template <typename U, size_t M>
+    template <typename U, size_t M, typename SU>
     friend class poly;
 
+    using value_type = T;
+    using storage_type = S;
+
     // KONSTRUKTORY
 
     // Konstruktor bezargumentowy tworzy wielomian tożsamościowo równy zeru
     constexpr poly() : a() {}
 
+    // Współczynniki nieokreślone - tylko dla wyników, które zaraz zostaną
+    // zapisane w całości (zob. detail::uninitialized_poly). Inne magazyny
+    // zerują bufor same albo, jak aligned, wymagają zerowego dopełnienia.
+    constexpr explicit poly(detail::uninitialized_t)
+        requires std::is_same_v<S, poly_storage::inline_buffer>
+    {
+    }
+
     // Konstruktor kopiujący bądź przenoszący (jednoargumentowe), których argument 
     // jest odpowiednio typu const poly<U, M>& bądź poly<U, M>&&, gdzie M <= N, 
     // a typ U jest konwertowalny do typu T.
 
-    template <typename U, size_t M>
-    constexpr poly(const poly<U, M> &other)
+    template <typename U, size_t M, typename SU>
+    constexpr poly(const poly<U, M, SU> &other)
         requires(N >= M) && (std::convertible_to<U, T>)
+        : a()
     {
+        [[maybe_unused]] detail::op_observer_t<T> observe(
+            detail::op_site_v<detail::poly_op::convert, poly<T, N, S>, poly<U, M, SU>>);
         for (size_t i = 0; i < M; i++)
         {
             a[i] = other[i];
         }
     }
 
-    template <typename U, size_t M>
-    constexpr poly(poly<U, M> &&other)
+    template <typename U, size_t M, typename SU>
+    constexpr poly(poly<U, M, SU> &&other)
         requires(N >= M) && (std::convertible_to<U, T>)
+        : a()
     {
-        init(std::forward<poly<U, M>>(other));
+        [[maybe_unused]] detail::op_observer_t<T> observe(
+            detail::op_site_v<detail::poly_op::convert, poly<T, N, S>, poly<U, M, SU>>);
+        init(std::forward<poly<U, M, SU>>(other));
     }
 
     // Konstruktor konwertujący (jednoargumentowy) o argumencie typu konwertowalnego 
     // do typu T tworzy wielomian rozmiaru 1.
+    // Bufor osadzony jest agregatem, więc a[0] inicjalizujemy bezpośrednio;
+    // pozostałe polityki mają własny konstruktor, stąd przypisanie.
     template <typename U>
     constexpr poly(U other)
-        requires std::convertible_to<U, T>
+        requires std::convertible_to<U, T> && std::is_same_v<S, poly_storage::inline_buffer>
         : a{static_cast<T>(other)}
     {
     }
 
+    template <typename U>
+    constexpr poly(U other)
+        requires std::convertible_to<U, T> && (!std::is_same_v<S, poly_storage::inline_buffer>)
+        : a()
+    {
+        a[0] = static_cast<T>(other);
+    }
+
     // Konstruktor wieloargumentowy (dwa lub więcej argumentów) tworzy wielomian 
     // o współczynnikach takich jak wartości kolejnych argumentów.
     // Liczba argumentów powinna być nie większa niż rozmiar wielomianu N, 
@@ -85,24 +272,28 @@ public:
         T arr[] = {static_cast<T>(std::forward<U>(args))...};
         for (size_t i = 0; i < sizeof...(args); i++)
         {
-            a[i] = arr[i];
+            a[i] = std::move(arr[i]);
         }
     }
 
     // OPERATORY PRZYPISANIA
-    template <typename U, size_t M>
-        requires(std::is_convertible_v<poly<U, M>, poly<T, N>>)
-    constexpr auto operator=(const poly<U, M> &other) -> poly<T, N> &
+    template <typename U, size_t M, typename SU>
+        requires(std::is_convertible_v<poly<U, M, SU>, poly<T, N, S>>)
+    constexpr auto operator=(const poly<U, M, SU> &other) -> poly<T, N, S> &
     {
+        [[maybe_unused]] detail::op_observer_t<T> observe(
+            detail::op_site_v<detail::poly_op::assign, poly<T, N, S>, poly<U, M, SU>>);
         if (!is_same_object(other))
             assign_elements(other);
         return *this;
     }
 
-    template <typename U, size_t M>
-        requires(std::is_convertible_v<poly<U, M>, poly<T, N>>)
-    constexpr auto operator=(poly<U, M> &&other) -> poly<T, N> &
+    template <typename U, size_t M, typename SU>
+        requires(std::is_convertible_v<poly<U, M, SU>, poly<T, N, S>>)
+    constexpr auto operator=(poly<U, M, SU> &&other) -> poly<T, N, S> &
     {
+        [[maybe_unused]] detail::op_observer_t<T> observe(
+            detail::op_site_v<detail::poly_op::assign, poly<T, N, S>, poly<U, M, SU>>);
         if (!is_same_object(other))
             assign_elements(std::move(other));
         return *this;
@@ -111,9 +302,9 @@ public:
     // OPERATORY ARYTMETYCZNE
 
     // +=
-    template <typename U, size_t M>
-        requires(std::is_convertible_v<poly<U, M>, poly<T, N>>)
-    constexpr poly<T, N> &operator+=(const poly<U, M> &other)
+    template <typename U, size_t M, typename SU>
+        requires(std::is_convertible_v<poly<U, M, SU>, poly<T, N, S>>)
+    constexpr poly<T, N, S> &operator+=(const poly<U, M, SU> &other)
     {
         for (size_t i = 0; i < M; ++i)
             a[i] += other[i];
@@ -122,16 +313,16 @@ public:
 
     template <typename U>
         requires(std::is_convertible_v<U, T>)
-    constexpr poly<T, N> &operator+=(const U &other)
+    constexpr poly<T, N, S> &operator+=(const U &other)
     {
         a[0] += other;
         return *this;
     }
 
     // -=
-    template <typename U, size_t M>
-        requires(std::is_convertible_v<poly<U, M>, poly<T, N>>)
-    constexpr poly<T, N> &operator-=(const poly<U, M> &other)
+    template <typename U, size_t M, typename SU>
+        requires(std::is_convertible_v<poly<U, M, SU>, poly<T, N, S>>)
+    constexpr poly<T, N, S> &operator-=(const poly<U, M, SU> &other)
     {
         for (size_t i = 0; i < M; ++i)
             a[i] -= other[i];
@@ -140,7 +331,7 @@ public:
 
     template <typename U>
         requires(std::is_convertible_v<U, T>)
-    constexpr poly<T, N> &operator-=(const U &other)
+    constexpr poly<T, N, S> &operator-=(const U &other)
     {
         a[0] -= other;
         return *this;
@@ -149,17 +340,17 @@ public:
     // *=
     template <typename U>
         requires(std::is_convertible_v<U, T>)
-    constexpr poly<T, N> &operator*=(const U &other)
+    constexpr poly<T, N, S> &operator*=(const U &other)
     {
-        for (auto &x : a)
-            x *= other;
+        for (size_t i = 0; i < N; ++i)
+            a[i] *= other;
         return *this;
     }
 
     // unary-
-    constexpr poly<T, N> operator-() const
+    constexpr poly<T, N, S> operator-() const
     {
-        poly<T, N> res;
+        poly<T, N, S> res;
         for (size_t i = 0; i < N; ++i)
             res[i] = -a[i];
         return res;
@@ -183,18 +374,41 @@ public:
         poly res = *this;
         return res;
     }
-    // Kiedy T też jest wielomianem
+    // Kiedy T też jest wielomianem. Kolejność zmiennych wybiera planer
+    // (at_cost): albo najpierw wewnętrzne wielomiany, a potem Horner po first,
+    // albo najpierw Horner po first na całych współczynnikach, a potem jedno
+    // wywołanie at() dla wewnętrznych zmiennych. Planer zmienia tylko
+    // kolejność składania - nie przechowuje ani nie współdzieli wyników
+    // pośrednich między wywołaniami.
+    // Dla współczynników zmiennoprzecinkowych obie kolejności są równe
+    // tylko w arytmetyce dokładnej: błędy zaokrągleń kumulują się inaczej,
+    // więc wynik może różnić się od kolejności domyślnej na ostatnich bitach.
     template <typename U, typename... Args>
     constexpr auto at(const U &first, Args &&...args) const
         requires(detail::is_poly_v<T>)
     {
-        return calc_at<U, 0, Args...>(first, std::forward<Args>(args)...);
+        [[maybe_unused]] detail::op_observer_t<T> observe(detail::op_site_v<detail::poly_op::at, poly, U>);
+        if constexpr (outer_first<U, std::remove_cvref_t<Args>...>())
+        {
+            using R = decltype(calc_at<U, 0, Args...>(first, std::forward<Args>(args)...));
+            return static_cast<R>(fold_outer(first).at(std::forward<Args>(args)...));
+        }
+        else
+            return calc_at<U, 0, Args...>(first, std::forward<Args>(args)...);
     }
     // Kiedy T nie jest już wielomianem
     template <typename U, typename... Args>
     constexpr auto at(const U &first, [[maybe_unused]] Args &&...args) const
         requires(!detail::is_poly_v<T>)
     {
+        [[maybe_unused]] detail::op_observer_t<T> observe(detail::op_site_v<detail::poly_op::at, poly, U>);
+        // do 4 współczynników estrin_range i tak liczy Hornerem, więc nie
+        // płacimy za sprawdzanie progu w czasie działania
+        if constexpr (detail::fast_mul_v<T, U> && N > 4)
+        {
+            if (!std::is_constant_evaluated() && N >= poly_tuning::estrin_cutoff)
+                return estrin_at(first);
+        }
         return calc_at<U, 0>(first);
     }
     // Wersja dla std::array
@@ -208,42 +422,162 @@ public:
     // METODA SIZE
     constexpr size_t size() const
     {
-        return a.size();
+        return N;
+    }
+
+    // Ciągły blok N współczynników, niezależnie od polityki przechowywania
+    constexpr T *data()
+    {
+        return a.data();
+    }
+
+    constexpr const T *data() const
+    {
+        return a.data();
     }
 
 private:
-    std::array<T, N> a;
+    typename S::template buffer<T, N> a;
 
-    template <typename U, size_t M>
-    constexpr void assign_elements(const poly<U, M> &other)
+    template <typename U, size_t M, typename SU>
+    constexpr void assign_elements(const poly<U, M, SU> &other)
     {
+        a.revive();
         size_t i = 0;
         while (i < M)
         {
             a[i] = other[i];
             ++i;
         }
-        while (i < N)
-        {
-            a[i] = 0;
-            ++i;
-        }
+        zero_from(M);
+    }
+
+    // przeniesienie współczynników z other; reszta jak wyżej
+    template <typename U, size_t M, typename SU>
+    constexpr void assign_elements(poly<U, M, SU> &&other)
+    {
+        a.revive();
+        init(std::move(other));
+        zero_from(M);
     }
 
-    template <typename U, size_t M>
-    constexpr void init(const poly<U, M> &other)
+    // wyrazy od first zerowane w miejscu, bez tymczasowego T i przeniesienia
+    constexpr void zero_from(size_t first)
+    {
+        for (size_t i = first; i < N; ++i)
+            if constexpr (std::is_nothrow_default_constructible_v<T>)
+            {
+                std::destroy_at(&a[i]);
+                std::construct_at(&a[i]);
+            }
+            else
+                a[i] = T();
+    }
+
+    template <typename U, size_t M, typename SU>
+    constexpr void init(const poly<U, M, SU> &other)
         requires(N >= M)
     {
         for (size_t i = 0; i < M; ++i)
             a[i] = static_cast<T>(other[i]);
     }
 
-    template <typename U, size_t M>
-    constexpr void init(poly<U, M> &&other)
+    template <typename U, size_t M, typename SU>
+    constexpr void init(poly<U, M, SU> &&other)
         requires(N >= M)
     {
+        // bez static_cast przy tym samym typie, żeby nie tworzyć tymczasowego T
         for (size_t i = 0; i < M; ++i)
-            a[i] = static_cast<T>(std::move(other[i]));
+            if constexpr (std::is_same_v<U, T>)
+                a[i] = std::move(other[i]);
+            else
+                a[i] = static_cast<T>(std::move(other[i]));
+    }
+
+    // PLANOWANIE at()
+    // Koszt at(U, Args...) przy kolejności zmiennych wybranej przez planer.
+    template <typename U, typename... Args>
+    static constexpr detail::eval_cost at_cost()
+    {
+        if constexpr (!detail::is_poly_v<T>)
+        {
+            using R = std::remove_cvref_t<decltype(std::declval<const poly &>().template calc_at<U, 0>(std::declval<const U &>()))>;
+            constexpr size_t res = detail::poly_scalar<R>::elements;
+            constexpr size_t arg = detail::poly_scalar<U>::elements;
+            return {(N - 1) * (arg * res + res), N - 1};
+        }
+        else if constexpr (outer_first<U, Args...>())
+            return outer_first_cost<U, Args...>();
+        else
+            return inner_first_cost<U, Args...>();
+    }
+
+    // koszt at() dla jednego współczynnika
+    template <typename... Args>
+    static constexpr detail::eval_cost coefficient_cost()
+    {
+        if constexpr (sizeof...(Args) == 0)
+            return {0, 0};
+        else
+            return T::template at_cost<Args...>();
+    }
+
+    // typ wyniku at(U, Args...) przy kolejności domyślnej (calc_at)
+    template <typename U, typename... Args>
+    using inner_first_t = std::remove_cvref_t<decltype(std::declval<const poly &>().template calc_at<U, 0, Args...>(
+        std::declval<const U &>(), std::declval<Args>()...))>;
+
+    // najpierw N wywołań at() dla współczynników, potem Horner po first
+    template <typename U, typename... Args>
+    static constexpr detail::eval_cost inner_first_cost()
+    {
+        using R = inner_first_t<U, Args...>;
+        constexpr size_t res = detail::poly_scalar<R>::elements;
+        constexpr size_t arg = detail::poly_scalar<U>::elements;
+        constexpr detail::eval_cost coeff = coefficient_cost<Args...>();
+        return {N * coeff.ops + (N - 1) * (arg * res + res), N * coeff.chain + (N - 1)};
+    }
+
+    // najpierw Horner po first na całych współczynnikach (działania na
+    // wszystkich skalarach współczynnika są niezależne), potem jedno at()
+    template <typename U, typename... Args>
+    static constexpr detail::eval_cost outer_first_cost()
+    {
+        constexpr size_t coeff_size = detail::poly_scalar<T>::elements;
+        constexpr detail::eval_cost coeff = coefficient_cost<Args...>();
+        return {(N - 1) * 2 * coeff_size + coeff.ops, (N - 1) + coeff.chain};
+    }
+
+    // Drugą kolejność stosujemy tylko dla skalarnego first, gdy są dalsze
+    // argumenty, współczynniki da się pomnożyć przez first (wspólny typ,
+    // zob. fold_outer) i wychodzi taniej.
+    template <typename U, typename... Args>
+    static constexpr bool outer_first()
+    {
+        if constexpr (!detail::is_poly_v<T> || detail::is_poly_v<U> || sizeof...(Args) == 0)
+            return false;
+        else if constexpr (!requires { typename std::common_type<T, U>::type; })
+            return false;
+        // akumulator fold_outer nie może być węższy niż wynik kolejności
+        // domyślnej, bo przepełnienie zależałoby od decyzji planera
+        else if constexpr (!std::is_same_v<detail::poly_scalar_t<std::common_type_t<T, U>>,
+                                           detail::poly_scalar_t<inner_first_t<U, Args...>>>)
+            return false;
+        else
+            return outer_first_cost<U, Args...>() < inner_first_cost<U, Args...>();
+    }
+
+    // Horner po first na całych współczynnikach, w miejscu
+    template <typename U>
+    constexpr auto fold_outer(const U &first) const
+    {
+        std::common_type_t<T, U> acc = a[N - 1];
+        for (size_t i = N - 1; i-- > 0;)
+        {
+            acc *= first;
+            acc += a[i];
+        }
+        return acc;
     }
 
     // pomocnicze funkcje do at()
@@ -254,9 +588,44 @@ private:
     {
         if constexpr (I == N - 1)
             return a[I];
+        else if constexpr (std::is_floating_point_v<T> && std::is_same_v<U, T>)
+            return detail::fmadd(first, calc_at<U, I + 1>(first), a[I]);
         else
             return (first * calc_at<U, I + 1>(first)) + a[I];
     }
+    // Schemat Estrina: p = p_lo + x^h p_hi, gdzie h to największa potęga
+    // dwójki mniejsza od długości, aż do kawałków liczonych Hornerem;
+    // łańcuch zależności ma długość O(log N) zamiast N, kosztem log N
+    // dodatkowych mnożeń na potęgi x.
+    template <typename U>
+    auto estrin_at(const U &first) const
+    {
+        using R = decltype(calc_at<U, 0>(first));
+        // x^(2^k) dla k < bit_width(N - 1): najwyższa czytana to x^bit_floor(N - 1);
+        // przy N <= 4 cały wielomian liczy Horner i wystarczy samo x
+        std::array<R, (N <= 4 ? 1 : std::bit_width(N - 1))> powers;
+        powers[0] = static_cast<R>(first);
+        for (size_t k = 1; k < powers.size(); ++k)
+            powers[k] = powers[k - 1] * powers[k - 1];
+        return estrin_range<R>(0, N, powers.data());
+    }
+
+    template <typename R>
+    R estrin_range(size_t lo, size_t len, const R *powers) const
+    {
+        // krótkie kawałki Hornerem: łańcuch i tak jest krótki
+        if (len <= 4)
+        {
+            R acc = static_cast<R>(a[lo + len - 1]);
+            for (size_t i = len - 1; i-- > 0;)
+                acc = detail::fmadd(powers[0], acc, static_cast<R>(a[lo + i]));
+            return acc;
+        }
+        size_t half = std::bit_floor(len - 1);
+        return detail::fmadd(powers[std::countr_zero(half)], estrin_range<R>(lo + half, len - half, powers),
+                             estrin_range<R>(lo, half, powers));
+    }
+
     // dla T, które są wielomianami rekurencyjnie wywołuję at()
     template <typename U, size_t I, typename... Args>
         requires(detail::is_poly_v<T>)
@@ -272,7 +641,7 @@ private:
     template <typename U>
     constexpr bool is_same_object(const U &other) const
     {
-        return (static_cast<const void *>(this) != static_cast<const void *>(&other));
+        return detail::same_object(*this, other);
     }
 };
 
@@ -280,94 +649,147 @@ private:
 template <typename... U>
 poly(U &&...) -> poly<std::common_type_t<U...>, sizeof...(U)>;
 
+// HASZOWANIE
+// Skrót wielomianu łączy skróty współczynników, więc dla zagnieżdżonych
+// wielomianów działa rekurencyjnie.
+template <typename T, size_t N, typename S>
+struct std::hash<poly<T, N, S>>
+{
+    size_t operator()(const poly<T, N, S> &p) const noexcept
+    {
+        size_t h = N;
+        for (size_t i = 0; i < N; ++i)
+            h = detail::hash_mix(h, std::hash<T>{}(p[i]));
+        return h;
+    }
+};
+
 // COMMON TYPE
 // reguły konwersji
 
-template <typename T, typename U, size_t N>
-struct std::common_type<poly<T, N>, poly<U, N>>
+template <typename T, typename U, size_t N, typename S, typename SU>
+struct std::common_type<poly<T, N, S>, poly<U, N, SU>>
 {
-    using type = poly<std::common_type_t<T, U>, N>;
+    using type = poly<std::common_type_t<T, U>, N, detail::common_storage_t<S, SU>>;
 };
 
-template <typename T, size_t N, typename U, size_t M>
-struct std::common_type<const poly<T, N>, const poly<U, M>>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+struct std::common_type<const poly<T, N, S>, const poly<U, M, SU>>
 {
-    using type = const poly<std::common_type_t<T, U>, std::max(N, M)>;
+    using type = const poly<std::common_type_t<T, U>, std::max(N, M), detail::common_storage_t<S, SU>>;
 };
 
-template <typename T, size_t N, typename U, size_t M>
-struct std::common_type<const poly<T, N>, poly<U, M>>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+struct std::common_type<const poly<T, N, S>, poly<U, M, SU>>
 {
-    using type = poly<std::common_type_t<T, U>, std::max(N, M)>;
+    using type = poly<std::common_type_t<T, U>, std::max(N, M), detail::common_storage_t<S, SU>>;
 };
 
-template <typename T, size_t N, typename U, size_t M>
-struct std::common_type<poly<T, N>, const poly<U, M>>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+struct std::common_type<poly<T, N, S>, const poly<U, M, SU>>
 {
-    using type = poly<std::common_type_t<T, U>, std::max(N, M)>;
+    using type = poly<std::common_type_t<T, U>, std::max(N, M), detail::common_storage_t<S, SU>>;
 };
 
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires(!detail::is_poly_v<U>)
-struct std::common_type<const poly<T, N>, U>
+struct std::common_type<const poly<T, N, S>, U>
 {
-    using type = poly<std::common_type_t<T, U>, N>;
+    using type = poly<std::common_type_t<T, U>, N, S>;
 };
 
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires(!detail::is_poly_v<U>)
-struct std::common_type<U, const poly<T, N>>
+struct std::common_type<U, const poly<T, N, S>>
 {
-    using type = poly<std::common_type_t<T, U>, N>;
+    using type = poly<std::common_type_t<T, U>, N, S>;
 };
 
-template <typename T, size_t N, typename U, size_t M>
-struct std::common_type<poly<T, N>, poly<U, M>>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+struct std::common_type<poly<T, N, S>, poly<U, M, SU>>
 {
-    using type = poly<std::common_type_t<T, U>, std::max(N, M)>;
+    using type = poly<std::common_type_t<T, U>, std::max(N, M), detail::common_storage_t<S, SU>>;
 };
 
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires(!detail::is_poly_v<U> && std::convertible_to<U, T>)
-struct std::common_type<poly<T, N>, U>
+struct std::common_type<poly<T, N, S>, U>
 {
-    using type = poly<std::common_type_t<T, U>, N>;
+    using type = poly<std::common_type_t<T, U>, N, S>;
 };
 
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires(!detail::is_poly_v<U> && std::convertible_to<U, T>)
-struct std::common_type<U, poly<T, N>>
+struct std::common_type<U, poly<T, N, S>>
 {
-    using type = poly<std::common_type_t<T, U>, N>;
+    using type = poly<std::common_type_t<T, U>, N, S>;
 };
 
 // OPERATORY ARYTMETYCZNE
 
+namespace detail
+{
+    // wynik do zapisania w całości: bez zerowania, gdy magazyn na to pozwala
+    template <typename P>
+    constexpr P uninitialized_poly()
+    {
+        if constexpr (std::is_constructible_v<P, uninitialized_t>)
+            return P(uninitialized);
+        else
+            return P();
+    }
+
+    // Dodawanie i odejmowanie wielomianów poly_storage::aligned tego samego
+    // typu liczbowego i rozmiaru idzie po całym dopełnionym bloku: zera
+    // dopełnienia dają zera, a pętla nie ma reszty.
+    template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+    inline constexpr bool padded_elementwise_v = std::is_same_v<S, poly_storage::aligned> &&
+                                                 std::is_same_v<SU, poly_storage::aligned> &&
+                                                 std::is_arithmetic_v<T> && std::is_same_v<T, U> && N == M;
+
+    template <typename T, size_t N, typename Op>
+    constexpr void padded_elementwise(const T *x, const T *y, T *res, Op op)
+    {
+        constexpr size_t count = poly_storage::aligned::padded_size<T, N>;
+        constexpr size_t align = poly_storage::aligned::alignment;
+        const T *ax = std::assume_aligned<align>(x);
+        const T *ay = std::assume_aligned<align>(y);
+        T *ar = std::assume_aligned<align>(res);
+        for (size_t i = 0; i < count; ++i)
+            ar[i] = op(ax[i], ay[i]);
+    }
+}
+
 // +
 
 // Tylko lewy argument to wielomian
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires((!detail::is_poly_v<U>) && std::is_convertible_v<U, T>)
-constexpr auto operator+(const poly<T, N> &x, const U &y)
+constexpr auto operator+(const poly<T, N, S> &x, const U &y)
 {
-    std::common_type_t<poly<T, N>, U> res = x;
+    std::common_type_t<poly<T, N, S>, U> res = x;
     res[0] = x[0] + y;
     return res;
 }
 
 // Tylko prawy argument to wielomian
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires((!detail::is_poly_v<U>) && std::is_convertible_v<U, T>)
-constexpr auto operator+(const U &y, const poly<T, N> &x)
+constexpr auto operator+(const U &y, const poly<T, N, S> &x)
 {
     return x + y;
 }
 // Oba argumenty to wielomiany
-template <typename T, size_t N, typename U, size_t M>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
     requires(std::is_convertible_v<U, T> || std::is_convertible_v<T, U>)
-constexpr auto operator+(const poly<T, N> &x, const poly<U, M> &y)
+constexpr auto operator+(const poly<T, N, S> &x, const poly<U, M, SU> &y)
 {
-    poly<std::common_type_t<T, U>, std::max(N, M)> res;
+    poly<std::common_type_t<T, U>, std::max(N, M), detail::common_storage_t<S, SU>> res;
+    if constexpr (detail::padded_elementwise_v<T, N, S, U, M, SU>)
+    {
+        detail::padded_elementwise<T, N>(x.data(), y.data(), res.data(), std::plus<T>());
+        return res;
+    }
     size_t both = std::min(x.size(), y.size());
     size_t i = 0;
     while (i < both)
@@ -390,29 +812,34 @@ constexpr auto operator+(const poly<T, N> &x, const poly<U, M> &y)
 
 // -
 // Tylko lewy argument to wielomian
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires((!detail::is_poly_v<U>) && std::is_convertible_v<U, T>)
-constexpr auto operator-(const poly<T, N> &x, const U &y)
+constexpr auto operator-(const poly<T, N, S> &x, const U &y)
 {
-    std::common_type_t<poly<T, N>, U> res = x;
+    std::common_type_t<poly<T, N, S>, U> res = x;
     res[0] = x[0] - y;
     return res;
 }
 // Tylko prawy argument to wielomian
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires((!detail::is_poly_v<U>) && std::is_convertible_v<U, T>)
-constexpr auto operator-(const U &y, const poly<T, N> &x)
+constexpr auto operator-(const U &y, const poly<T, N, S> &x)
 {
-    std::common_type_t<poly<T, N>, U> res = -x;
+    std::common_type_t<poly<T, N, S>, U> res = -x;
     res[0] = y - x[0];
     return res;
 }
 // Oba argumenty to wielomiany
-template <typename T, size_t N, typename U, size_t M>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
     requires((std::is_convertible_v<U, T> || std::is_convertible_v<T, U>))
-constexpr auto operator-(const poly<T, N> &x, const poly<U, M> &y)
+constexpr auto operator-(const poly<T, N, S> &x, const poly<U, M, SU> &y)
 {
-    poly<std::common_type_t<T, U>, std::max(N, M)> res;
+    poly<std::common_type_t<T, U>, std::max(N, M), detail::common_storage_t<S, SU>> res;
+    if constexpr (detail::padded_elementwise_v<T, N, S, U, M, SU>)
+    {
+        detail::padded_elementwise<T, N>(x.data(), y.data(), res.data(), std::minus<T>());
+        return res;
+    }
     size_t both = std::min(x.size(), y.size());
     size_t i = 0;
     while (i < both)
@@ -433,56 +860,177 @@ constexpr auto operator-(const poly<T, N> &x, const poly<U, M> &y)
     return res;
 }
 
+namespace detail
+{
+    // PODSTAWIENIE KRONECKERA
+    // Wielomian wielu zmiennych zapisujemy jako jeden wielomian jednej zmiennej:
+    // i-ty współczynnik poziomu, któremu w wyniku odpowiada typ R, trafia na
+    // pozycję i * (liczba skalarów w R::value_type). Odstępy są wymiarami
+    // wyniku iloczynu, więc wyrazy iloczynu spakowanych czynników się nie
+    // nakładają i wynik rozpakowujemy tym samym układem.
+
+    // length: ostatnia zajęta pozycja + 1 po spakowaniu A w układzie R
+    template <typename R, typename A>
+    struct kronecker_layout
+    {
+        static constexpr size_t length = 1;
+    };
+
+    template <typename R, typename U, size_t M, typename S>
+    struct kronecker_layout<R, poly<U, M, S>>
+    {
+        using inner = typename R::value_type;
+        static constexpr size_t length =
+            M == 0 ? 0 : (M - 1) * poly_scalar<inner>::elements + kronecker_layout<inner, U>::length;
+    };
+
+    template <typename R, typename A, typename V>
+    constexpr void kronecker_pack(const A &a, V *out)
+    {
+        if constexpr (is_poly_v<A>)
+        {
+            using inner = typename R::value_type;
+            for (size_t i = 0; i < a.size(); ++i)
+                kronecker_pack<inner>(a[i], out + i * poly_scalar<inner>::elements);
+        }
+        else
+            *out = static_cast<V>(a);
+    }
+
+    template <typename R, typename V>
+    constexpr void kronecker_unpack(R &r, const V *in, size_t length)
+    {
+        if constexpr (is_poly_v<R>)
+        {
+            constexpr size_t stride = poly_scalar<typename R::value_type>::elements;
+            for (size_t i = 0; i < r.size() && i * stride < length; ++i)
+                kronecker_unpack(r[i], in + i * stride, length - i * stride);
+        }
+        else
+            r = *in;
+    }
+
+    // Podstawienie stosujemy do zagnieżdżonych wielomianów o współczynnikach
+    // liczbowych, gdy krótszy spakowany czynnik jest dość długi dla Karatsuby;
+    // poniżej progu zagnieżdżone mnożenie szkolne jest tańsze, bo nie mnoży
+    // zer dopełniających.
+    template <typename R, typename X, typename Y>
+    inline constexpr bool kronecker_v = poly_depth_v<R> >= 2 &&
+                                        fast_mul_v<poly_scalar_t<X>, poly_scalar_t<Y>>;
+
+    template <typename R, typename X, typename Y>
+    inline constexpr size_t kronecker_min_length = std::min(kronecker_layout<R, X>::length, kronecker_layout<R, Y>::length);
+
+    // res = x * y jednym mnożeniem mul_fast; res musi być wyzerowany
+    template <typename R, typename X, typename Y>
+    constexpr void kronecker_multiply(const X &x, const Y &y, R &res, size_t cutoff)
+    {
+        using V = poly_scalar_t<R>;
+        constexpr size_t n = kronecker_layout<R, X>::length, m = kronecker_layout<R, Y>::length;
+        std::vector<V> a(n), b(m), c(n + m - 1);
+        kronecker_pack<R>(x, a.data());
+        kronecker_pack<R>(y, b.data());
+        mul_fast(a.data(), n, b.data(), m, c.data(), cutoff);
+        kronecker_unpack(res, c.data(), c.size());
+    }
+}
+
 // *
 // Tylko lewy argument to wielomian
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires((!detail::is_poly_v<U>) && (std::is_convertible_v<U, T> || std::is_convertible_v<T, U>))
-constexpr auto operator*(const poly<T, N> &x, const U &y)
+constexpr auto operator*(const poly<T, N, S> &x, const U &y)
 {
-    poly<std::common_type_t<T, U>, N> res;
+    [[maybe_unused]] detail::op_observer_t<T> observe(detail::op_site_v<detail::poly_op::multiply, poly<T, N, S>, U>);
+    poly<std::common_type_t<T, U>, N, S> res;
     for (size_t i = 0; i < N; ++i)
         res[i] = x[i] * y;
     return res;
 }
 // Tylko prawy argument to wielomian
-template <typename T, size_t N, typename U>
+template <typename T, size_t N, typename S, typename U>
     requires((!detail::is_poly_v<U>) && (std::is_convertible_v<U, T> || std::is_convertible_v<T, U>))
-constexpr auto operator*(const U &y, const poly<T, N> &x)
+constexpr auto operator*(const U &y, const poly<T, N, S> &x)
 {
     return x * y;
 }
 // Oba argumenty to wielomiany
-template <typename T, size_t N, typename U, size_t M>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
     requires((std::is_convertible_v<U, T> || std::is_convertible_v<T, U>) && (N > 0 && M > 0))
-constexpr auto operator*(const poly<T, N> &x, const poly<U, M> &y)
+constexpr auto operator*(const poly<T, N, S> &x, const poly<U, M, SU> &y)
 {
-    poly<decltype(x[0] * y[0]), N + M - 1> res;
+    [[maybe_unused]] detail::op_observer_t<T> observe(
+        detail::op_site_v<detail::poly_op::multiply, poly<T, N, S>, poly<U, M, SU>>);
+    using R = poly<decltype(x[0] * y[0]), N + M - 1, detail::common_storage_t<S, SU>>;
+    if constexpr (detail::small_product_v<T, U, N, M>)
+    {
+        // small_product zapisuje każdy współczynnik, więc bez zerowania
+        R res = detail::uninitialized_poly<R>();
+        detail::small_product<N, M>(x.data(), y.data(), res.data());
+        return res;
+    }
+    R res;
+    // duże iloczyny liczbowe liczymy Karatsubą, także w czasie kompilacji
+    if constexpr (detail::fast_mul_v<T, U>)
+    {
+        if (std::is_constant_evaluated())
+        {
+            if constexpr (std::min(N, M) > poly_tuning::constexpr_karatsuba_cutoff)
+            {
+                detail::mul_fast_convert(x.data(), N, y.data(), M, res.data(), poly_tuning::constexpr_karatsuba_cutoff);
+                return res;
+            }
+        }
+        else if (std::min(N, M) > poly_tuning::karatsuba_cutoff)
+        {
+            detail::mul_fast_convert(x.data(), N, y.data(), M, res.data(), poly_tuning::karatsuba_cutoff);
+            return res;
+        }
+    }
+    // zagnieżdżone - jednym długim iloczynem po podstawieniu Kroneckera
+    else if constexpr (detail::kronecker_v<decltype(res), poly<T, N, S>, poly<U, M, SU>>)
+    {
+        constexpr size_t length = detail::kronecker_min_length<decltype(res), poly<T, N, S>, poly<U, M, SU>>;
+        if (std::is_constant_evaluated())
+        {
+            if constexpr (length > poly_tuning::constexpr_karatsuba_cutoff)
+            {
+                detail::kronecker_multiply(x, y, res, poly_tuning::constexpr_karatsuba_cutoff);
+                return res;
+            }
+        }
+        else if (length > poly_tuning::karatsuba_cutoff)
+        {
+            detail::kronecker_multiply(x, y, res, poly_tuning::karatsuba_cutoff);
+            return res;
+        }
+    }
     for (size_t i = 0; i < N; ++i)
         for (size_t j = 0; j < M; ++j)
             res[i + j] = res[i + j] + (x[i] * y[j]);
 
     return res;
 }
-template <typename T, size_t N, typename U, size_t M>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
     requires((std::is_convertible_v<U, T> || std::is_convertible_v<T, U>) && (N == 0 || M == 0))
-constexpr auto operator*([[maybe_unused]] const poly<T, N> &x, [[maybe_unused]] const poly<U, M> &y)
+constexpr auto operator*([[maybe_unused]] const poly<T, N, S> &x, [[maybe_unused]] const poly<U, M, SU> &y)
 {
-    return poly<std::common_type_t<T, U>, 0>{};
+    return poly<std::common_type_t<T, U>, 0, detail::common_storage_t<S, SU>>{};
 }
 
-template <typename T_From, size_t N_From, typename T_To, size_t N_To>
-struct std::is_convertible<poly<T_From, N_From>, poly<T_To, N_To>>
+template <typename T_From, size_t N_From, typename S_From, typename T_To, size_t N_To, typename S_To>
+struct std::is_convertible<poly<T_From, N_From, S_From>, poly<T_To, N_To, S_To>>
 {
     static constexpr bool value = (std::is_convertible_v<T_From, T_To>) && (N_To >= N_From);
 };
 
 // CONST POLY
 
-template <typename T, size_t N>
-constexpr poly<poly<T, N>, 1> const_poly(poly<T, N> p)
+template <typename T, size_t N, typename S>
+constexpr poly<poly<T, N, S>, 1, S> const_poly(poly<T, N, S> p)
 {
-    poly<poly<T, N>, 1> res{};
-    res[0] = p;
+    poly<poly<T, N, S>, 1, S> res{};
+    res[0] = std::move(p);
     return res;
 }
 
@@ -493,33 +1041,36 @@ struct cross_type
     using type = std::common_type_t<T, U>;
 };
 
-template <typename T, size_t N, typename U, size_t M>
-struct cross_type<poly<T, N>, poly<U, M>>
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+struct cross_type<poly<T, N, S>, poly<U, M, SU>>
 {
-    using type = poly<typename cross_type<T, poly<U, M>>::type, N>;
+    using type = poly<typename cross_type<T, poly<U, M, SU>>::type, N, S>;
 };
 
-template <typename T, typename U, size_t M>
-struct cross_type<T, poly<U, M>>
+template <typename T, typename U, size_t M, typename SU>
+struct cross_type<T, poly<U, M, SU>>
 {
-    using type = poly<std::common_type_t<T, U>, M>;
+    using type = poly<std::common_type_t<T, U>, M, SU>;
 };
 
 // FUNKCJA CROSS
 
-template <typename T, typename U, size_t M>
-constexpr auto cross(const T &p, const poly<U, M> &q)
+template <typename T, typename U, size_t M, typename SU>
+constexpr auto cross(const T &p, const poly<U, M, SU> &q)
     requires(!detail::is_poly_v<T>)
 {
-    typename cross_type<T, poly<U, M>>::type result = p * q;
+    [[maybe_unused]] detail::op_observer_t<U> observe(detail::op_site_v<detail::poly_op::cross, T, poly<U, M, SU>>);
+    typename cross_type<T, poly<U, M, SU>>::type result = p * q;
     return result;
 }
 
-template <typename T, size_t N, typename U, size_t M>
-constexpr auto cross(const poly<T, N> &p, const poly<U, M> &q)
-    requires(detail::is_poly_v<poly<T, N>> && detail::is_poly_v<poly<U, M>>)
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+constexpr auto cross(const poly<T, N, S> &p, const poly<U, M, SU> &q)
+    requires(detail::is_poly_v<poly<T, N, S>> && detail::is_poly_v<poly<U, M, SU>>)
 {
-    typename cross_type<poly<T, N>, poly<U, M>>::type result;
+    [[maybe_unused]] detail::op_observer_t<T> observe(
+        detail::op_site_v<detail::poly_op::cross, poly<T, N, S>, poly<U, M, SU>>);
+    typename cross_type<poly<T, N, S>, poly<U, M, SU>>::type result;
     for (size_t i = 0; i < N; i++)
     {
         result[i] = cross(p[i], q);
@@ -528,4 +1079,172 @@ constexpr auto cross(const poly<T, N> &p, const poly<U, M> &q)
     return result;
 }
 
+// POTĘGOWANIE
+
+// p * p; dla małych i nieliczbowych współczynników każdy iloczyn p[i] p[j]
+// (i != j) liczony jest raz, czyli około połowy mnożeń zwykłego iloczynu
+template <typename T, size_t N, typename S>
+    requires(N > 0)
+constexpr auto square(const poly<T, N, S> &p)
+{
+    using R = decltype(p[0] * p[0]);
+    if constexpr (detail::fast_mul_v<T, T>)
+    {
+        if (std::is_constant_evaluated() ? N > poly_tuning::constexpr_karatsuba_cutoff
+                                         : N > poly_tuning::karatsuba_cutoff)
+            return p * p;
+    }
+    [[maybe_unused]] detail::op_observer_t<T> observe(
+        detail::op_site_v<detail::poly_op::multiply, poly<T, N, S>, poly<T, N, S>>);
+    poly<R, 2 * N - 1, S> res;
+    for (size_t i = 0; i < N; ++i)
+        for (size_t j = i + 1; j < N; ++j)
+            res[i + j] = res[i + j] + p[i] * p[j];
+    for (size_t k = 0; k < 2 * N - 1; ++k)
+        res[k] = res[k] + res[k];
+    for (size_t i = 0; i < N; ++i)
+        res[2 * i] = res[2 * i] + p[i] * p[i];
+    return res;
+}
+
+// p^K o rozmiarze (N - 1) K + 1, przez podnoszenie do kwadratu
+template <size_t K, typename T, size_t N, typename S>
+    requires(N > 0)
+constexpr auto pow(const poly<T, N, S> &p)
+{
+    if constexpr (K == 0)
+    {
+        poly<T, 1, S> res;
+        res[0] = T(1);
+        return res;
+    }
+    else if constexpr (K == 1)
+        return p;
+    else if constexpr (K % 2 == 0)
+        return square(pow<K / 2>(p));
+    else
+        return square(pow<K / 2>(p)) * p;
+}
+
+// p^k obcięte do B współczynników (p^k mod x^B) dla k znanego dopiero w
+// czasie działania programu
+template <size_t B, typename T, size_t N, typename S>
+    requires(B > 0 && N > 0)
+constexpr poly<T, B, S> pow_truncated(const poly<T, N, S> &p, unsigned long long k)
+{
+    constexpr size_t M = std::min(N, B);
+    poly<T, M, S> base;
+    for (size_t i = 0; i < M; ++i)
+        base[i] = p[i];
+
+    poly<T, B, S> res;
+    res[0] = T(1);
+    bool started = false;
+    for (int bit = std::bit_width(k); bit-- > 0;)
+    {
+        if (started)
+            res = detail::truncate<B>(square(res));
+        if ((k >> bit) & 1)
+        {
+            if (started)
+                res = detail::truncate<B>(res * base);
+            else
+                res = base;
+            started = true;
+        }
+    }
+    return res;
+}
+
+// FUNKCJE AKUMULUJĄCE
+// fma_into(acc, p, q) dodaje p * q, a cross_into(acc, p, q) dodaje
+// cross(p, q) do istniejącego wielomianu acc, nie tworząc wyników pośrednich
+// (także dla zagnieżdżonych współczynników). Zgodność rozmiarów sprawdzana
+// jest w czasie kompilacji tą samą regułą co przy przypisaniu.
+// acc może być tym samym obiektem co p lub q - wtedy fma_into mnoży kopię
+// tego argumentu. Nie może natomiast być współczynnikiem p ani q (ani ich
+// zawierać), bo zapis acc[i + j] zmieniłby czynniki jeszcze potrzebne.
+// Iloczyny współczynników liczbowych dłuższe niż karatsuba_cutoff fma_into
+// liczy Karatsubą do bufora typu współczynników acc i dopiero go dodaje;
+// mniejsze oraz zagnieżdżone na zewnętrznym poziomie - szkolnie w miejscu.
+
+template <typename A, size_t K, typename SA, typename T, size_t N, typename S, typename U, size_t M, typename SU>
+    requires(N == 0 || M == 0 ||
+             std::is_convertible_v<decltype(std::declval<poly<T, N, S>>() * std::declval<poly<U, M, SU>>()), poly<A, K, SA>>)
+constexpr poly<A, K, SA> &fma_into(poly<A, K, SA> &acc, const poly<T, N, S> &p, const poly<U, M, SU> &q);
+
+template <typename A, size_t K, typename SA, typename T, size_t N, typename S, typename Q>
+    requires(std::is_convertible_v<typename cross_type<poly<T, N, S>, Q>::type, poly<A, K, SA>>)
+constexpr poly<A, K, SA> &cross_into(poly<A, K, SA> &acc, const poly<T, N, S> &p, const Q &q);
+
+namespace detail
+{
+    // acc += x * y dla pojedynczych współczynników
+    template <typename A, typename X, typename Y>
+    constexpr void fma_coeff(A &acc, const X &x, const Y &y)
+    {
+        if constexpr (is_poly_v<X> && is_poly_v<Y>)
+            fma_into(acc, x, y);
+        else if constexpr (is_poly_v<X>)
+        {
+            for (size_t k = 0; k < x.size(); ++k)
+                fma_coeff(acc[k], x[k], y);
+        }
+        else if constexpr (is_poly_v<Y>)
+        {
+            for (size_t k = 0; k < y.size(); ++k)
+                fma_coeff(acc[k], x, y[k]);
+        }
+        else if constexpr (is_poly_v<A>)
+            fma_coeff(acc[0], x, y);
+        else
+            acc += x * y;
+    }
+}
+
+template <typename A, size_t K, typename SA, typename T, size_t N, typename S, typename U, size_t M, typename SU>
+    requires(N == 0 || M == 0 ||
+             std::is_convertible_v<decltype(std::declval<poly<T, N, S>>() * std::declval<poly<U, M, SU>>()), poly<A, K, SA>>)
+constexpr poly<A, K, SA> &fma_into(poly<A, K, SA> &acc, const poly<T, N, S> &p, const poly<U, M, SU> &q)
+{
+    [[maybe_unused]] detail::op_observer_t<A> observe(
+        detail::op_site_v<detail::poly_op::fma_into, poly<T, N, S>, poly<U, M, SU>>);
+    if constexpr (detail::fast_mul_v<T, U> && detail::fast_mul_v<A, A> && N > 0 && M > 0)
+    {
+        size_t cutoff = std::is_constant_evaluated() ? poly_tuning::constexpr_karatsuba_cutoff
+                                                     : poly_tuning::karatsuba_cutoff;
+        if (std::min(N, M) > cutoff)
+        {
+            std::vector<A> prod(N + M - 1);
+            detail::mul_fast_convert(p.data(), N, q.data(), M, prod.data(), cutoff);
+            for (size_t k = 0; k < N + M - 1; ++k)
+                acc[k] += prod[k];
+            return acc;
+        }
+    }
+    if (detail::same_object(acc, p))
+        return fma_into(acc, poly<T, N, S>(p), q);
+    if (detail::same_object(acc, q))
+        return fma_into(acc, p, poly<U, M, SU>(q));
+    for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < M; ++j)
+            detail::fma_coeff(acc[i + j], p[i], q[j]);
+    return acc;
+}
+
+template <typename A, size_t K, typename SA, typename T, size_t N, typename S, typename Q>
+    requires(std::is_convertible_v<typename cross_type<poly<T, N, S>, Q>::type, poly<A, K, SA>>)
+constexpr poly<A, K, SA> &cross_into(poly<A, K, SA> &acc, const poly<T, N, S> &p, const Q &q)
+{
+    [[maybe_unused]] detail::op_observer_t<A> observe(detail::op_site_v<detail::poly_op::cross_into, poly<T, N, S>, Q>);
+    for (size_t i = 0; i < N; ++i)
+    {
+        if constexpr (detail::is_poly_v<T>)
+            cross_into(acc[i], p[i], q);
+        else
+            detail::fma_coeff(acc[i], p[i], q);
+    }
+    return acc;
+}
+
 #endif // POLY_H
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef POLY_AUTOTUNE_H
+#define POLY_AUTOTUNE_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "poly.h"
+
+// Strojenie progów algorytmów (poly_tuning) na danej maszynie: pomiar
+// mnożenia szkolnego i Karatsuby oraz schematów Hornera i Estrina dla
+// typowych rozmiarów i typów współczynników, z zapisem wyników do pliku,
+// który kolejne uruchomienia tylko wczytują.
+//
+//     poly_autotune::tune();   // wczytaj poly_tuning.cache albo zmierz i zapisz
+//
+// Plik wskazuje zmienna środowiskowa POLY_TUNING_CACHE, domyślnie
+// poly_tuning.cache w bieżącym katalogu.
+
+// Zestaw progów poly_tuning, które da się stroić.
+struct poly_tuning_profile
+{
+    size_t karatsuba_cutoff;
+    size_t estrin_cutoff;
+
+    static poly_tuning_profile current()
+    {
+        return {poly_tuning::karatsuba_cutoff, poly_tuning::estrin_cutoff};
+    }
+
+    void apply() const
+    {
+        poly_tuning::karatsuba_cutoff = karatsuba_cutoff;
+        poly_tuning::estrin_cutoff = estrin_cutoff;
+    }
+
+    bool operator==(const poly_tuning_profile &) const = default;
+};
+
+namespace poly_autotune
+{
+    // wersja formatu pliku; inny nagłówek oznacza plik do ponownego pomiaru
+    inline constexpr const char *cache_header = "poly_tuning 1";
+
+    inline std::string default_cache_path()
+    {
+        const char *env = std::getenv("POLY_TUNING_CACHE");
+        return env != nullptr && *env != '\0' ? env : "poly_tuning.cache";
+    }
+
+    // Profil z pliku albo nic, gdy pliku nie ma, ma inną wersję lub brakuje
+    // w nim któregoś progu.
+    inline std::optional<poly_tuning_profile> load(const std::string &path)
+    {
+        std::ifstream in(path);
+        std::string line;
+        if (!in || !std::getline(in, line) || line != cache_header)
+            return std::nullopt;
+        std::optional<size_t> karatsuba, estrin;
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string key;
+            size_t value;
+            if (!(fields >> key >> value))
+                continue;
+            if (key == "karatsuba_cutoff")
+                karatsuba = value;
+            else if (key == "estrin_cutoff")
+                estrin = value;
+        }
+        if (!karatsuba || !estrin)
+            return std::nullopt;
+        return poly_tuning_profile{*karatsuba, *estrin};
+    }
+
+    inline bool save(const poly_tuning_profile &profile, const std::string &path)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << cache_header << '\n'
+            << "karatsuba_cutoff " << profile.karatsuba_cutoff << '\n'
+            << "estrin_cutoff " << profile.estrin_cutoff << '\n';
+        return static_cast<bool>(out.flush());
+    }
+
+    namespace detail
+    {
+        inline volatile double sink;
+
+        // najlepszy z kilku pomiarów średniego czasu f(), w sekundach; każdy
+        // pomiar trwa co najmniej min_seconds, a zegar czytamy co partię
+        // wywołań, żeby nie mierzyć jego samego
+        template <typename F>
+        double time_of(F &&f, double min_seconds)
+        {
+            using clock = std::chrono::steady_clock;
+            double best = 0;
+            for (int round = 0; round < 3; ++round)
+            {
+                size_t reps = 0;
+                auto start = clock::now();
+                double elapsed;
+                do
+                {
+                    for (size_t i = 0; i < 64; ++i)
+                        f();
+                    reps += 64;
+                    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+                } while (elapsed < min_seconds);
+                double each = elapsed / static_cast<double>(reps);
+                if (round == 0 || each < best)
+                    best = each;
+            }
+            return best;
+        }
+
+        template <typename R>
+        std::vector<R> sample(size_t n, size_t seed)
+        {
+            std::vector<R> v(n);
+            for (size_t i = 0; i < n; ++i)
+                v[i] = static_cast<R>((i * 7 + seed * 13) % 19) - R(9);
+            return v;
+        }
+
+        // czas iloczynu n x n: szkolnego i Karatsuby z jednym podziałem
+        template <typename R>
+        std::pair<double, double> multiply_times(size_t n, double min_seconds)
+        {
+            auto a = sample<R>(n, 1), b = sample<R>(n, 2);
+            std::vector<R> out(2 * n - 1);
+            size_t half = n - n / 2;
+            std::vector<R> scratch(::detail::karatsuba_scratch(n, half));
+            double school = time_of([&] {
+                ::detail::mul_schoolbook(a.data(), n, b.data(), n, out.data());
+                sink = static_cast<double>(out[n]);
+            }, min_seconds);
+            double split = time_of([&] {
+                ::detail::karatsuba(a.data(), b.data(), n, out.data(), scratch.data(), half);
+                sink = static_cast<double>(out[n]);
+            }, min_seconds);
+            return {school, split};
+        }
+
+        // czas at() Hornerem i Estrinem dla poly<R, N>
+        template <typename R, size_t N>
+        std::pair<double, double> evaluation_times(double min_seconds)
+        {
+            poly<R, N> p;
+            auto c = sample<R>(N, 3);
+            for (size_t i = 0; i < N; ++i)
+                p[i] = c[i];
+            R x = R(1) / R(3);
+            auto run = [&] {
+                x = x + R(1e-9);
+                sink = static_cast<double>(p.at(x));
+            };
+            size_t saved = poly_tuning::estrin_cutoff;
+            poly_tuning::estrin_cutoff = static_cast<size_t>(-1);
+            double horner = time_of(run, min_seconds);
+            poly_tuning::estrin_cutoff = 0;
+            double estrin = time_of(run, min_seconds);
+            poly_tuning::estrin_cutoff = saved;
+            return {horner, estrin};
+        }
+
+        // Pierwszy rozmiar, od którego druga metoda wygrywa także dla kolejnego
+        // mierzonego rozmiaru; zwraca poprzedni rozmiar (ostatni, na którym
+        // wygrywa pierwsza metoda) albo fallback, gdy druga nie wygrywa nigdy.
+        inline size_t crossover(const std::vector<size_t> &sizes, const std::vector<bool> &second_wins,
+                                size_t before_first, size_t fallback)
+        {
+            for (size_t i = 0; i < sizes.size(); ++i)
+                if (second_wins[i] && (i + 1 == sizes.size() || second_wins[i + 1]))
+                    return i == 0 ? before_first : sizes[i - 1];
+            return fallback;
+        }
+
+        template <size_t... N>
+        size_t tune_estrin(double min_seconds)
+        {
+            std::vector<size_t> sizes{N...};
+            std::vector<bool> wins;
+            (wins.push_back([&] {
+                auto [hd, ed] = evaluation_times<double, N>(min_seconds);
+                auto [hf, ef] = evaluation_times<float, N>(min_seconds);
+                return ed + ef < hd + hf;
+            }()), ...);
+            // próg to pierwszy rozmiar, od którego stosujemy Estrina
+            size_t last_horner = crossover(sizes, wins, sizes.front() - 1, static_cast<size_t>(-1));
+            return last_horner == static_cast<size_t>(-1) ? last_horner : last_horner + 1;
+        }
+    }
+
+    // Mierzy progi na tej maszynie: mnożenie dla double i long long (rozmiary
+    // do 256), at() dla double i float (rozmiary do 128).
+    // Trwa tym dłużej, im większe min_seconds - czas jednego pomiaru.
+    inline poly_tuning_profile measure(double min_seconds = 2e-3)
+    {
+        poly_tuning_profile profile = poly_tuning_profile::current();
+
+        std::vector<size_t> sizes{8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+        std::vector<bool> wins;
+        for (size_t n : sizes)
+        {
+            auto [sd, kd] = detail::multiply_times<double>(n, min_seconds);
+            auto [sl, kl] = detail::multiply_times<long long>(n, min_seconds);
+            wins.push_back(kd + kl < sd + sl);
+        }
+        // Karatsuba dla rozmiarów większych niż ostatni wygrany przez szkolne
+        profile.karatsuba_cutoff = detail::crossover(sizes, wins, sizes.front() - 1, sizes.back());
+
+        profile.estrin_cutoff = detail::tune_estrin<4, 8, 16, 32, 64, 128>(min_seconds);
+        return profile;
+    }
+
+    // Wczytuje profil z pliku, a gdy go nie ma - mierzy i zapisuje.
+    // Profil jest od razu stosowany.
+    inline poly_tuning_profile tune(const std::string &path = default_cache_path())
+    {
+        std::optional<poly_tuning_profile> profile = load(path);
+        if (!profile)
+        {
+            profile = measure();
+            save(*profile, path);
+        }
+        profile->apply();
+        return *profile;
+    }
+}
+
+#endif // POLY_AUTOTUNE_H
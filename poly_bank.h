@@ -0,0 +1,211 @@
+#ifndef POLY_BANK_H
+#define POLY_BANK_H
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "poly.h"
+
+namespace detail
+{
+    // Iloczyny Lanes par naraz: r_k[l] = a_k(x) * b_k(x) dla linii l < Lanes,
+    // gdzie i-te współczynniki kolejnych par leżą w wierszu a + i * stride_a
+    // (b, r podobnie). Pętla wewnętrzna idzie po liniach i ma stałą długość,
+    // więc kolejne pary trafiają do kolejnych linii rejestrów SIMD także przy
+    // -O2. Kolejność sumowania taka sama jak w small_product (wyniki równe
+    // operator* dla T == U zmiennoprzecinkowego i N, M <= unroll_limit).
+    template <size_t N, size_t M, size_t Lanes, typename R, typename A, typename B>
+    void lane_product(const A *__restrict a, size_t stride_a, const B *__restrict b, size_t stride_b,
+                      R *__restrict r, size_t stride_r)
+    {
+        for (size_t k = 0; k < N + M - 1; ++k)
+        {
+            size_t lo = k + 1 > M ? k + 1 - M : 0;
+            size_t hi = std::min(k, N - 1);
+            R *__restrict out = r + k * stride_r;
+            const A *__restrict x = a + lo * stride_a;
+            const B *__restrict y = b + (k - lo) * stride_b;
+            for (size_t l = 0; l < Lanes; ++l)
+                out[l] = static_cast<R>(x[l]) * static_cast<R>(y[l]);
+            for (size_t i = lo + 1; i <= hi; ++i)
+            {
+                x = a + i * stride_a;
+                y = b + (k - i) * stride_b;
+                for (size_t l = 0; l < Lanes; ++l)
+                    out[l] = fmadd(static_cast<R>(x[l]), static_cast<R>(y[l]), out[l]);
+            }
+        }
+    }
+
+    // linie przetwarzane jednym wywołaniem lane_product
+    inline constexpr size_t batch_lanes = 64;
+}
+
+// Bank wielomianów poly<T, N> w układzie struktury tablic: i-ty współczynnik
+// wszystkich wielomianów leży w jednym ciągłym wierszu. Dzięki temu
+// obliczanie wartości wielu wielomianów naraz to schemat Hornera, w którym
+// kolejne wielomiany trafiają do kolejnych linii rejestrów SIMD. Tak samo
+// multiply_all mnoży naraz wiele par wielomianów z dwóch banków; wynik jako
+// bank jest szybszy niż jako tablica wielomianów, która wymaga transpozycji.
+template <typename T, size_t N>
+class poly_bank
+{
+public:
+    poly_bank() = default;
+
+    // count wielomianów tożsamościowo równych zeru
+    explicit poly_bank(size_t count) : n(count), c(N * count) {}
+
+    template <typename S>
+    explicit poly_bank(const std::vector<poly<T, N, S>> &polys) : poly_bank(polys.size())
+    {
+        // transpozycja blokami, żeby zapisy do N wierszy nie wyrzucały się z pamięci podręcznej
+        for (size_t start = 0; start < n; start += block)
+        {
+            size_t end = std::min(n, start + block);
+            for (size_t i = 0; i < N; ++i)
+            {
+                T *row = coefficients(i);
+                for (size_t k = start; k < end; ++k)
+                    row[k] = polys[k][i];
+            }
+        }
+    }
+
+    template <typename S = poly_storage::inline_buffer>
+    std::vector<poly<T, N, S>> to_vector() const
+    {
+        std::vector<poly<T, N, S>> polys(n);
+        for (size_t start = 0; start < n; start += block)
+        {
+            size_t end = std::min(n, start + block);
+            for (size_t i = 0; i < N; ++i)
+            {
+                const T *row = coefficients(i);
+                for (size_t k = start; k < end; ++k)
+                    polys[k][i] = row[k];
+            }
+        }
+        return polys;
+    }
+
+    size_t size() const { return n; }
+
+    // wiersz i-tych współczynników wszystkich wielomianów
+    T *coefficients(size_t i) { return c.data() + i * n; }
+    const T *coefficients(size_t i) const { return c.data() + i * n; }
+
+    poly<T, N> get(size_t k) const
+    {
+        poly<T, N> p;
+        for (size_t i = 0; i < N; ++i)
+            p[i] = c[i * n + k];
+        return p;
+    }
+
+    template <typename S>
+    void set(size_t k, const poly<T, N, S> &p)
+    {
+        for (size_t i = 0; i < N; ++i)
+            c[i * n + k] = p[i];
+    }
+
+    // out[k] = k-ty wielomian w punkcie x
+    void evaluate_all(const T &x, T *out) const
+    {
+        for (size_t start = 0; start < n; start += block)
+            horner(start, std::min(n, start + block), [x](size_t) { return x; }, out);
+    }
+
+    // out[k] = k-ty wielomian w punkcie xs[k]
+    void evaluate_all(const T *xs, T *out) const
+    {
+        for (size_t start = 0; start < n; start += block)
+            horner(start, std::min(n, start + block), [xs](size_t k) { return xs[k]; }, out);
+    }
+
+    std::vector<T> evaluate_all(const T &x) const
+    {
+        std::vector<T> out(n);
+        evaluate_all(x, out.data());
+        return out;
+    }
+
+    // k-ty wielomian wyniku = a.get(k) * b.get(k); banki muszą mieć ten sam
+    // rozmiar
+    template <typename U, size_t M>
+        requires(detail::fast_mul_v<T, U> && N > 0 && M > 0)
+    friend auto multiply_all(const poly_bank &a, const poly_bank<U, M> &b)
+    {
+        assert(a.size() == b.size());
+        using R = decltype(std::declval<T>() * std::declval<U>());
+        constexpr size_t lanes = detail::batch_lanes;
+        poly_bank<R, N + M - 1> res(a.size());
+        size_t full = a.size() - a.size() % lanes;
+        for (size_t start = 0; start < full; start += lanes)
+            detail::lane_product<N, M, lanes>(a.coefficients(0) + start, a.size(), b.coefficients(0) + start,
+                                              b.size(), res.coefficients(0) + start, res.size());
+        for (size_t k = full; k < a.size(); ++k)
+            res.set(k, a.get(k) * b.get(k));
+        return res;
+    }
+
+    // out[k] = a.get(k) * b.get(k), wynik jako ciągła tablica wielomianów;
+    // banki muszą mieć ten sam rozmiar
+    template <typename U, size_t M, typename SR>
+        requires(detail::fast_mul_v<T, U> && N > 0 && M > 0)
+    friend void multiply_all(const poly_bank &a, const poly_bank<U, M> &b,
+                             poly<decltype(std::declval<T>() * std::declval<U>()), N + M - 1, SR> *out)
+    {
+        assert(a.size() == b.size());
+        using R = decltype(std::declval<T>() * std::declval<U>());
+        constexpr size_t lanes = detail::batch_lanes;
+        alignas(64) R r[N + M - 1][lanes];
+        size_t full = a.size() - a.size() % lanes;
+        for (size_t start = 0; start < full; start += lanes)
+        {
+            detail::lane_product<N, M, lanes>(a.coefficients(0) + start, a.size(), b.coefficients(0) + start,
+                                              b.size(), &r[0][0], lanes);
+            for (size_t k = 0; k < N + M - 1; ++k)
+                for (size_t l = 0; l < lanes; ++l)
+                    out[start + l][k] = r[k][l];
+        }
+        for (size_t k = full; k < a.size(); ++k)
+            out[k] = a.get(k) * b.get(k);
+    }
+
+private:
+    // liczba wielomianów przetwarzanych naraz; wynik bloku mieści się w L1
+    static constexpr size_t block = 1024;
+
+    size_t n = 0;
+    std::vector<T> c;
+
+    template <typename Point>
+    void horner(size_t start, size_t end, Point point, T *__restrict out) const
+    {
+        if constexpr (N == 0)
+        {
+            std::fill(out + start, out + end, T());
+        }
+        else
+        {
+            const T *__restrict top = coefficients(N - 1);
+            for (size_t k = start; k < end; ++k)
+                out[k] = top[k];
+            for (size_t i = N - 1; i-- > 0;)
+            {
+                const T *__restrict row = coefficients(i);
+                // fmadd jak w poly::at(), żeby zaokrąglenia były te same
+                for (size_t k = start; k < end; ++k)
+                    out[k] = detail::fmadd(out[k], point(k), row[k]);
+            }
+        }
+    }
+};
+
+#endif // POLY_BANK_H
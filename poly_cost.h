@@ -0,0 +1,264 @@
+#ifndef POLY_COST_H
+#define POLY_COST_H
+
+#include <cstddef>
+#include <array>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "poly.h"
+
+// Model kosztu: typ współczynników poly_cost::counted<T> liczy wykonane na nim
+// działania pierścienia, a obserwator operacji z poly.h przypisuje je do
+// najbardziej zewnętrznej trwającej operacji wielomianu (operator*, at(),
+// cross(), przypisanie, konwersja, fma_into, cross_into). Liczniki są osobne
+// dla każdego wątku.
+namespace poly_cost
+{
+    using detail::poly_op;
+
+    inline constexpr size_t op_count = static_cast<size_t>(poly_op::cross_into) + 1;
+
+    struct counts
+    {
+        size_t multiplications = 0;
+        size_t additions = 0;
+        size_t subtractions = 0;
+        size_t negations = 0;
+        size_t conversions = 0;
+
+        constexpr size_t total() const
+        {
+            return multiplications + additions + subtractions + negations + conversions;
+        }
+
+        constexpr bool operator==(const counts &) const = default;
+
+        counts &operator+=(const counts &other)
+        {
+            multiplications += other.multiplications;
+            additions += other.additions;
+            subtractions += other.subtractions;
+            negations += other.negations;
+            conversions += other.conversions;
+            return *this;
+        }
+    };
+
+    // Koszty przypisane operacjom; outside to działania wykonane poza
+    // jakąkolwiek operacją wielomianu.
+    struct report
+    {
+        std::array<counts, op_count> by_op{};
+        counts outside{};
+
+        const counts &operator[](poly_op op) const { return by_op[static_cast<size_t>(op)]; }
+        counts &operator[](poly_op op) { return by_op[static_cast<size_t>(op)]; }
+
+        counts total() const
+        {
+            counts sum = outside;
+            for (const auto &c : by_op)
+                sum += c;
+            return sum;
+        }
+    };
+
+    inline const char *op_name(poly_op op) { return detail::poly_op_name(op); }
+
+    namespace internal
+    {
+        struct state
+        {
+            report current;
+            // operacja, do której trafiają koszty, albo nullptr poza operacjami
+            counts *target = nullptr;
+        };
+
+        inline state &thread_state()
+        {
+            thread_local state s;
+            return s;
+        }
+
+        inline counts &sink()
+        {
+            state &s = thread_state();
+            return s.target != nullptr ? *s.target : s.current.outside;
+        }
+    }
+
+    // Zeruje liczniki bieżącego wątku.
+    inline void reset() { internal::thread_state().current = report{}; }
+
+    // Liczniki bieżącego wątku od ostatniego reset().
+    inline report snapshot() { return internal::thread_state().current; }
+
+    // Koszt wykonania f() w bieżącym wątku.
+    template <typename F>
+    report measure(F &&f)
+    {
+        report saved = snapshot();
+        reset();
+        std::forward<F>(f)();
+        report result = snapshot();
+        internal::thread_state().current = saved;
+        return result;
+    }
+
+    inline std::ostream &operator<<(std::ostream &os, const counts &c)
+    {
+        return os << "mul=" << c.multiplications << " add=" << c.additions << " sub=" << c.subtractions
+                  << " neg=" << c.negations << " conv=" << c.conversions;
+    }
+
+    inline std::ostream &operator<<(std::ostream &os, const report &r)
+    {
+        for (size_t i = 0; i < op_count; ++i)
+            if (r.by_op[i].total() != 0)
+                os << op_name(static_cast<poly_op>(i)) << ": " << r.by_op[i] << '\n';
+        if (r.outside.total() != 0)
+            os << "outside: " << r.outside << '\n';
+        return os;
+    }
+
+    // Współczynnik zliczający działania. Wartości liczone w czasie kompilacji
+    // nie są zliczane.
+    template <typename T>
+    class counted
+    {
+    public:
+        constexpr counted() : value() {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U, T>)
+        constexpr counted(const U &u) : value(static_cast<T>(u))
+        {
+            tick(&counts::conversions);
+        }
+
+        template <typename U>
+            requires(std::is_convertible_v<U, T> && !std::is_same_v<U, T>)
+        constexpr counted(const counted<U> &u) : value(static_cast<T>(u.get()))
+        {
+            tick(&counts::conversions);
+        }
+
+        constexpr const T &get() const { return value; }
+
+        constexpr counted &operator+=(const counted &other)
+        {
+            tick(&counts::additions);
+            value += other.value;
+            return *this;
+        }
+
+        constexpr counted &operator-=(const counted &other)
+        {
+            tick(&counts::subtractions);
+            value -= other.value;
+            return *this;
+        }
+
+        constexpr counted &operator*=(const counted &other)
+        {
+            tick(&counts::multiplications);
+            value *= other.value;
+            return *this;
+        }
+
+        friend constexpr counted operator+(const counted &a, const counted &b)
+        {
+            tick(&counts::additions);
+            return raw(a.value + b.value);
+        }
+
+        friend constexpr counted operator-(const counted &a, const counted &b)
+        {
+            tick(&counts::subtractions);
+            return raw(a.value - b.value);
+        }
+
+        friend constexpr counted operator*(const counted &a, const counted &b)
+        {
+            tick(&counts::multiplications);
+            return raw(a.value * b.value);
+        }
+
+        constexpr counted operator-() const
+        {
+            tick(&counts::negations);
+            return raw(-value);
+        }
+
+        friend constexpr bool operator==(const counted &a, const counted &b) { return a.value == b.value; }
+
+        friend std::ostream &operator<<(std::ostream &os, const counted &c) { return os << c.value; }
+
+    private:
+        T value;
+
+        static constexpr counted raw(T v)
+        {
+            counted c;
+            c.value = v;
+            return c;
+        }
+
+        static constexpr void tick(size_t counts::*field)
+        {
+            if (!std::is_constant_evaluated())
+                ++(internal::sink().*field);
+        }
+    };
+}
+
+template <typename T, typename U>
+struct std::common_type<poly_cost::counted<T>, poly_cost::counted<U>>
+{
+    using type = poly_cost::counted<std::common_type_t<T, U>>;
+};
+
+template <typename T, typename U>
+    requires(std::is_arithmetic_v<U>)
+struct std::common_type<poly_cost::counted<T>, U>
+{
+    using type = poly_cost::counted<std::common_type_t<T, U>>;
+};
+
+template <typename T, typename U>
+    requires(std::is_arithmetic_v<U>)
+struct std::common_type<U, poly_cost::counted<T>>
+{
+    using type = poly_cost::counted<std::common_type_t<T, U>>;
+};
+
+// Obserwator kierujący koszty do najbardziej zewnętrznej trwającej operacji.
+template <typename T>
+struct detail::op_observer<poly_cost::counted<T>>
+{
+    poly_cost::counts *previous = nullptr;
+
+    constexpr explicit op_observer(const op_site &site)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            auto &s = poly_cost::internal::thread_state();
+            previous = s.target;
+            if (previous == nullptr)
+                s.target = &s.current[site.op];
+        }
+    }
+
+    constexpr ~op_observer()
+    {
+        if (!std::is_constant_evaluated())
+            poly_cost::internal::thread_state().target = previous;
+    }
+
+    op_observer(const op_observer &) = delete;
+    op_observer &operator=(const op_observer &) = delete;
+};
+
+#endif // POLY_COST_H
@@ -0,0 +1,133 @@
+#ifndef POLY_GRADIENT_H
+#define POLY_GRADIENT_H
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#include "poly.h"
+
+#ifdef POLY_PARALLEL
+#include "poly_parallel.h"
+#endif
+
+// Wartość i gradient wielomianu wielu zmiennych w jednym przejściu po
+// współczynnikach: at() liczone na liczbach dualnych (automatyczne
+// różniczkowanie w przód). Pierwsza pochodna odpowiada pierwszemu
+// argumentowi, czyli najbardziej zewnętrznej zmiennej.
+//
+//     auto [value, gradient] = at_with_gradient(p, x, y, z);
+
+// Liczba dualna: wartość i pochodne cząstkowe po D zmiennych.
+template <typename T, size_t D>
+struct dual
+{
+    T value{};
+    std::array<T, D> gradient{};
+
+    constexpr dual() = default;
+    constexpr dual(const T &value) : value(value) {}
+
+    // zmienna numer i: pochodna 1 po sobie, 0 po pozostałych
+    static constexpr dual variable(const T &value, size_t i)
+    {
+        dual d(value);
+        d.gradient[i] = T(1);
+        return d;
+    }
+
+    friend constexpr dual operator+(dual a, const dual &b)
+    {
+        a.value += b.value;
+        for (size_t i = 0; i < D; ++i)
+            a.gradient[i] += b.gradient[i];
+        return a;
+    }
+
+    friend constexpr dual operator+(dual a, const T &b)
+    {
+        a.value += b;
+        return a;
+    }
+
+    friend constexpr dual operator+(const T &a, dual b) { return b + a; }
+
+    // (a + a'e)(b + b'e) = ab + (a b' + a' b)e
+    friend constexpr dual operator*(const dual &a, const dual &b)
+    {
+        dual r(a.value * b.value);
+        for (size_t i = 0; i < D; ++i)
+            r.gradient[i] = a.value * b.gradient[i] + a.gradient[i] * b.value;
+        return r;
+    }
+
+    friend constexpr dual operator*(dual a, const T &b)
+    {
+        a.value *= b;
+        for (size_t i = 0; i < D; ++i)
+            a.gradient[i] *= b;
+        return a;
+    }
+
+    friend constexpr dual operator*(const T &a, dual b) { return b * a; }
+};
+
+namespace detail
+{
+    template <typename T, size_t D, typename R>
+    constexpr dual<T, D> as_dual(const R &r)
+    {
+        if constexpr (std::is_same_v<R, dual<T, D>>)
+            return r;
+        else
+            // wielomian stopnia 0 w ostatnich zmiennych zwraca skalar
+            return dual<T, D>(static_cast<T>(r));
+    }
+
+    template <typename T, size_t D, typename P, size_t... I>
+    constexpr dual<T, D> gradient_at(const P &p, const std::array<T, D> &point, std::index_sequence<I...>)
+    {
+        return as_dual<T, D>(p.at(dual<T, D>::variable(point[I], I)...));
+    }
+}
+
+// Wartość i wszystkie pochodne cząstkowe p w punkcie (xs...). Liczba
+// argumentów musi być równa głębokości zagnieżdżenia p.
+template <typename T, size_t N, typename S, typename... Xs>
+    requires(sizeof...(Xs) == detail::poly_depth_v<poly<T, N, S>> &&
+             requires { typename std::common_type<detail::poly_scalar_t<T>, Xs...>::type; })
+constexpr auto at_with_gradient(const poly<T, N, S> &p, const Xs &...xs)
+{
+    using R = std::common_type_t<detail::poly_scalar_t<T>, Xs...>;
+    constexpr size_t D = sizeof...(Xs);
+    return detail::gradient_at<R, D>(p, std::array<R, D>{static_cast<R>(xs)...}, std::make_index_sequence<D>());
+}
+
+// Wersja wsadowa: out[k] = at_with_gradient(p, points[k]...) dla k < count
+// (przy POLY_PARALLEL dla dużych partii równolegle).
+template <typename T, size_t N, typename S, typename R, size_t D>
+    requires(D == detail::poly_depth_v<poly<T, N, S>>)
+void at_with_gradient(const poly<T, N, S> &p, const std::array<R, D> *points, size_t count, dual<R, D> *out)
+{
+    auto evaluate = [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k)
+            out[k] = detail::gradient_at<R, D>(p, points[k], std::make_index_sequence<D>());
+    };
+#ifdef POLY_PARALLEL
+    poly_thread_pool &pool = poly_thread_pool::instance();
+    if (pool.size() > 1 && count >= 1024)
+    {
+        size_t chunk = (count + 4 * pool.size() - 1) / (4 * pool.size());
+        poly_thread_pool::task_group group(pool);
+        for (size_t lo = 0; lo < count; lo += chunk)
+            group.spawn([&evaluate, lo, hi = std::min(count, lo + chunk)] { evaluate(lo, hi); });
+        group.wait();
+        return;
+    }
+#endif
+    evaluate(0, count);
+}
+
+#endif // POLY_GRADIENT_H
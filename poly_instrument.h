@@ -0,0 +1,272 @@
+#ifndef POLY_INSTRUMENT_H
+#define POLY_INSTRUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Pomiar czasu operacji wielomianów (operator*, at(), cross(), przypisania,
+// konwersje, fma_into, cross_into), włączany przez zdefiniowanie
+// POLY_INSTRUMENT przed dołączeniem poly.h. Bez tego makra obserwator
+// operacji jest pusty i nic nie kosztuje. Makro musi być zdefiniowane w całym
+// programie albo w żadnej jego części: zmienia definicję
+// detail::op_observer, a różnica między jednostkami translacji to ciche
+// naruszenie ODR.
+//
+// Każda konkretyzacja operacji (detail::op_site) ma licznik wywołań, łączny
+// i największy czas oraz histogram czasów w kubełkach potęg dwójki
+// nanosekund. Czas jest włącznie z operacjami zagnieżdżonymi (np. cross()
+// zawiera swoje operator*). Wątki zapisują do własnych buforów bez blokad;
+// collect() i dump() zbierają je w dowolnym momencie, także po
+// zakończeniu wątków.
+//
+// Plik dołączany przez poly.h - nie należy go dołączać bezpośrednio.
+
+namespace poly_instrument
+{
+    // kubełek k: czasy z przedziału [2^(k-1), 2^k) ns; kubełek 0 to 0 ns
+    inline constexpr size_t buckets = 40;
+    // tyle różnych konkretyzacji operacji zapisuje jeden wątek
+    inline constexpr size_t thread_slots = 256;
+
+    // Zebrane dane jednej konkretyzacji operacji.
+    struct record
+    {
+        const detail::op_site *site;
+        uint64_t calls = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        std::array<uint64_t, buckets> histogram{};
+
+        const char *op() const { return detail::poly_op_name(site->op); }
+
+        // typy argumentów, np. "X = poly<double, 3>; Y = double"
+        std::string signature() const
+        {
+            std::string s = site->signature();
+            size_t begin = s.find("[with ");
+            if (begin == std::string::npos)
+                return s;
+            begin += 6;
+            size_t end = s.rfind(']');
+            return s.substr(begin, end == std::string::npos || end < begin ? std::string::npos : end - begin);
+        }
+    };
+
+    namespace internal
+    {
+        // Zapisuje tylko wątek-właściciel, więc wystarczają zwykłe odczyty
+        // i zapisy atomowe (bez read-modify-write); atomowość pozwala czytać
+        // bufor innym wątkom w trakcie pomiaru.
+        struct slot
+        {
+            std::atomic<const detail::op_site *> site{nullptr};
+            std::atomic<uint64_t> calls{0};
+            std::atomic<uint64_t> total_ns{0};
+            std::atomic<uint64_t> max_ns{0};
+            std::array<std::atomic<uint64_t>, buckets> histogram{};
+        };
+
+        inline void bump(std::atomic<uint64_t> &a, uint64_t by)
+        {
+            a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+        }
+
+        struct thread_buffer
+        {
+            std::array<slot, thread_slots> slots;
+            // wywołania, które nie zmieściły się w buforze
+            std::atomic<uint64_t> dropped{0};
+            thread_buffer *next = nullptr;
+        };
+
+        inline std::atomic<thread_buffer *> &buffers()
+        {
+            static std::atomic<thread_buffer *> head{nullptr};
+            return head;
+        }
+
+        // Bufor bieżącego wątku. Bufory nie są zwalniane, żeby dane
+        // zakończonych wątków zostały do zebrania.
+        inline thread_buffer &local()
+        {
+            thread_local thread_buffer *mine = [] {
+                auto *b = new thread_buffer;
+                b->next = buffers().load(std::memory_order_relaxed);
+                while (!buffers().compare_exchange_weak(b->next, b, std::memory_order_release,
+                                                        std::memory_order_relaxed))
+                {
+                }
+                return b;
+            }();
+            return *mine;
+        }
+
+        inline void add(const detail::op_site &site, uint64_t ns)
+        {
+            thread_buffer &b = local();
+            size_t h = std::hash<const void *>{}(&site) % thread_slots;
+            for (size_t probe = 0; probe < thread_slots; ++probe)
+            {
+                slot &s = b.slots[(h + probe) % thread_slots];
+                const detail::op_site *key = s.site.load(std::memory_order_relaxed);
+                if (key == nullptr)
+                {
+                    s.site.store(&site, std::memory_order_release);
+                    key = &site;
+                }
+                if (key == &site)
+                {
+                    bump(s.calls, 1);
+                    bump(s.total_ns, ns);
+                    if (ns > s.max_ns.load(std::memory_order_relaxed))
+                        s.max_ns.store(ns, std::memory_order_relaxed);
+                    bump(s.histogram[std::min<size_t>(std::bit_width(ns), buckets - 1)], 1);
+                    return;
+                }
+            }
+            bump(b.dropped, 1);
+        }
+    }
+
+    // Mierzy czas od utworzenia do zniszczenia (poza czasem kompilacji).
+    class timer
+    {
+    public:
+        constexpr explicit timer(const detail::op_site &site) : site(&site)
+        {
+            if (!std::is_constant_evaluated())
+                start = std::chrono::steady_clock::now().time_since_epoch().count();
+        }
+
+        constexpr ~timer()
+        {
+            if (!std::is_constant_evaluated())
+            {
+                int64_t end = std::chrono::steady_clock::now().time_since_epoch().count();
+                internal::add(*site, static_cast<uint64_t>(
+                                         std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::duration(end - start))
+                                             .count()));
+            }
+        }
+
+        timer(const timer &) = delete;
+        timer &operator=(const timer &) = delete;
+
+    private:
+        const detail::op_site *site;
+        int64_t start = 0;
+    };
+
+    // Dane ze wszystkich wątków, posumowane po konkretyzacjach, od
+    // największego łącznego czasu.
+    inline std::vector<record> collect()
+    {
+        std::map<const detail::op_site *, record> merged;
+        for (auto *b = internal::buffers().load(std::memory_order_acquire); b != nullptr; b = b->next)
+            for (const auto &s : b->slots)
+            {
+                const detail::op_site *site = s.site.load(std::memory_order_acquire);
+                if (site == nullptr)
+                    continue;
+                record &r = merged[site];
+                r.site = site;
+                r.calls += s.calls.load(std::memory_order_relaxed);
+                r.total_ns += s.total_ns.load(std::memory_order_relaxed);
+                r.max_ns = std::max(r.max_ns, s.max_ns.load(std::memory_order_relaxed));
+                for (size_t k = 0; k < buckets; ++k)
+                    r.histogram[k] += s.histogram[k].load(std::memory_order_relaxed);
+            }
+        std::vector<record> res;
+        for (auto &[site, r] : merged)
+            res.push_back(r);
+        std::stable_sort(res.begin(), res.end(),
+                         [](const record &a, const record &b) { return a.total_ns > b.total_ns; });
+        return res;
+    }
+
+    // wywołania pominięte, bo bufor wątku był pełny
+    inline uint64_t dropped()
+    {
+        uint64_t total = 0;
+        for (auto *b = internal::buffers().load(std::memory_order_acquire); b != nullptr; b = b->next)
+            total += b->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    enum class format
+    {
+        text,
+        json
+    };
+
+    namespace internal
+    {
+        inline void json_string(std::ostream &os, const std::string &s)
+        {
+            os << '"';
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\')
+                    os << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20)
+                    os << ' ';
+                else
+                    os << c;
+            }
+            os << '"';
+        }
+    }
+
+    // Tekst: jeden wiersz na konkretyzację i niepuste kubełki histogramu
+    // ("<2^k ns: liczba"). JSON: tablica obiektów z tymi samymi polami,
+    // histogram jako tablica liczb dla kolejnych kubełków.
+    inline void dump(std::ostream &os, format f = format::text)
+    {
+        std::vector<record> records = collect();
+        if (f == format::json)
+        {
+            os << "[";
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                const record &r = records[i];
+                os << (i ? ",\n " : "\n ") << "{\"op\": ";
+                internal::json_string(os, r.op());
+                os << ", \"n\": " << r.site->n << ", \"m\": " << r.site->m << ", \"depth\": " << r.site->depth
+                   << ", \"signature\": ";
+                internal::json_string(os, r.signature());
+                os << ", \"calls\": " << r.calls << ", \"total_ns\": " << r.total_ns << ", \"max_ns\": " << r.max_ns
+                   << ", \"histogram\": [";
+                for (size_t k = 0; k < buckets; ++k)
+                    os << (k ? ", " : "") << r.histogram[k];
+                os << "]}";
+            }
+            os << "\n]\n";
+            return;
+        }
+        for (const record &r : records)
+        {
+            os << r.op() << " n=" << r.site->n << " m=" << r.site->m << " depth=" << r.site->depth
+               << " calls=" << r.calls << " total=" << r.total_ns << "ns mean=" << (r.calls ? r.total_ns / r.calls : 0)
+               << "ns max=" << r.max_ns << "ns [" << r.signature() << "]\n";
+            for (size_t k = 0; k < buckets; ++k)
+                if (r.histogram[k] != 0)
+                    os << "    <2^" << k << " ns: " << r.histogram[k] << '\n';
+        }
+        if (uint64_t d = dropped())
+            os << "dropped " << d << " calls\n";
+    }
+}
+
+#endif // POLY_INSTRUMENT_H
@@ -0,0 +1,335 @@
+#ifndef POLY_INTERN_H
+#define POLY_INTERN_H
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "poly.h"
+
+// Internowanie wielomianów (hash-consing): równe wielomiany typu P dostają
+// ten sam uchwyt interned<P>, wskazujący jedyną kopię w globalnej puli typu P.
+// Uchwyty porównuje się i haszuje po adresie, a wyniki operator* na
+// uchwytach są zapamiętywane; at() zapamiętuje tylko at_memoized(). Pule
+// żyją do końca programu, a tablice wyników mają ograniczoną pojemność
+// (memo_capacity) i można je czyścić. Wszystko jest bezpieczne dla wielu
+// wątków (tablice są podzielone na niezależnie blokowane części).
+
+template <typename P>
+class interned;
+
+namespace detail
+{
+    // równość wartości, także dla zagnieżdżonych wielomianów
+    template <typename A, typename B>
+    constexpr bool deep_equal(const A &a, const B &b)
+    {
+        if constexpr (is_poly_v<A> && is_poly_v<B>)
+        {
+            if (a.size() != b.size())
+                return false;
+            for (size_t i = 0; i < a.size(); ++i)
+                if (!deep_equal(a[i], b[i]))
+                    return false;
+            return true;
+        }
+        else
+            return a == b;
+    }
+
+    struct deep_equal_to
+    {
+        template <typename A>
+        bool operator()(const A &a, const A &b) const { return deep_equal(a, b); }
+    };
+
+    // krotka argumentów: skrót i równość element po elemencie
+    struct tuple_hash
+    {
+        template <typename... Ts>
+        size_t operator()(const std::tuple<Ts...> &t) const
+        {
+            return std::apply([](const auto &...xs) {
+                size_t h = sizeof...(Ts);
+                ((h = hash_mix(h, std::hash<std::decay_t<decltype(xs)>>{}(xs))), ...);
+                return h;
+            }, t);
+        }
+    };
+
+    struct tuple_equal
+    {
+        template <typename... Ts>
+        bool operator()(const std::tuple<Ts...> &a, const std::tuple<Ts...> &b) const
+        {
+            return std::apply([&](const auto &...xs) {
+                return std::apply([&](const auto &...ys) { return (deep_equal(xs, ys) && ...); }, b);
+            }, a);
+        }
+    };
+
+    inline constexpr size_t intern_shards = 64;
+
+    inline size_t shard_of(size_t hash)
+    {
+        // wyższe bity, bo niższe wybiera kubełek tablicy
+        return (hash ^ (hash >> 29) ^ (hash >> 47)) % intern_shards;
+    }
+
+    // domyślna pojemność jednej tablicy zapamiętanych wyników
+    inline constexpr size_t memo_capacity = size_t(1) << 16;
+
+    // Zapamiętane wyniki: klucz -> wartość, z licznikami trafień. Część,
+    // która przekroczyłaby swoją porcję pojemności, jest czyszczona w całości.
+    template <typename Key, typename Value, typename Hash, typename Equal>
+    class memo_table
+    {
+    public:
+        template <typename F>
+        Value get(const Key &key, F &&compute)
+        {
+            size_t h = Hash{}(key);
+            shard &s = shards[shard_of(h)];
+            {
+                std::lock_guard lock(s.mutex);
+                auto it = s.map.find(key);
+                if (it != s.map.end())
+                {
+                    hit_count.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+            }
+            // liczymy bez blokady; przy wyścigu zostaje pierwszy wynik
+            miss_count.fetch_add(1, std::memory_order_relaxed);
+            Value v = std::forward<F>(compute)();
+            std::lock_guard lock(s.mutex);
+            if (s.map.size() >= shard_capacity.load(std::memory_order_relaxed) && !s.map.contains(key))
+                s.map.clear();
+            return s.map.emplace(key, std::move(v)).first->second;
+        }
+
+        size_t hits() const { return hit_count.load(std::memory_order_relaxed); }
+        size_t misses() const { return miss_count.load(std::memory_order_relaxed); }
+
+        // liczba zapamiętanych wyników
+        size_t size()
+        {
+            size_t total = 0;
+            for (shard &s : shards)
+            {
+                std::lock_guard lock(s.mutex);
+                total += s.map.size();
+            }
+            return total;
+        }
+
+        // usuwa wszystkie wyniki; liczniki trafień zostają
+        void clear()
+        {
+            for (shard &s : shards)
+            {
+                std::lock_guard lock(s.mutex);
+                s.map.clear();
+            }
+        }
+
+        // najwięcej capacity wyników (zaokrąglone w górę do liczby części)
+        void set_capacity(size_t capacity)
+        {
+            shard_capacity.store(std::max<size_t>(1, (capacity + intern_shards - 1) / intern_shards),
+                                 std::memory_order_relaxed);
+        }
+
+        static memo_table &instance()
+        {
+            static memo_table table;
+            return table;
+        }
+
+    private:
+        struct shard
+        {
+            std::mutex mutex;
+            std::unordered_map<Key, Value, Hash, Equal> map;
+        };
+
+        std::array<shard, intern_shards> shards;
+        std::atomic<size_t> hit_count{0}, miss_count{0};
+        std::atomic<size_t> shard_capacity{memo_capacity / intern_shards};
+    };
+
+    template <typename A, typename B>
+    using product_t = decltype(std::declval<const A &>() * std::declval<const B &>());
+
+    template <typename P, typename Q>
+    using product_memo = memo_table<std::tuple<const P *, const Q *>, interned<product_t<P, Q>>, tuple_hash, tuple_equal>;
+
+    template <typename P, typename... Args>
+    using at_result_t = decltype(std::declval<const P &>().at(std::declval<const Args &>()...));
+
+    template <typename P, typename... Args>
+    using at_memo = memo_table<std::tuple<const P *, Args...>, at_result_t<P, Args...>, tuple_hash, tuple_equal>;
+}
+
+// Globalna pula równych sobie wielomianów typu P.
+template <typename P>
+    requires(detail::is_poly_v<P>)
+class poly_intern_pool
+{
+public:
+    static poly_intern_pool &instance()
+    {
+        static poly_intern_pool pool;
+        return pool;
+    }
+
+    interned<P> intern(const P &p)
+    {
+        size_t h = std::hash<P>{}(p);
+        shard &s = shards[detail::shard_of(h)];
+        std::lock_guard lock(s.mutex);
+        return interned<P>(&*s.set.insert(p).first);
+    }
+
+    // liczba różnych wielomianów w puli
+    size_t size()
+    {
+        size_t total = 0;
+        for (shard &s : shards)
+        {
+            std::lock_guard lock(s.mutex);
+            total += s.set.size();
+        }
+        return total;
+    }
+
+private:
+    struct shard
+    {
+        std::mutex mutex;
+        // węzły unordered_set nie zmieniają adresu przy przehaszowaniu
+        std::unordered_set<P, std::hash<P>, detail::deep_equal_to> set;
+    };
+
+    std::array<shard, detail::intern_shards> shards;
+
+    poly_intern_pool() = default;
+};
+
+// Uchwyt internowanego wielomianu; równe wielomiany mają równe uchwyty.
+template <typename P>
+class interned
+{
+public:
+    interned() = default;
+
+    const P &operator*() const { return *p; }
+    const P *operator->() const { return p; }
+    const P &get() const { return *p; }
+
+    explicit operator bool() const { return p != nullptr; }
+
+    friend bool operator==(interned a, interned b) { return a.p == b.p; }
+
+    template <typename... Args>
+    detail::at_result_t<P, std::decay_t<Args>...> at(const Args &...args) const
+    {
+        return p->at(args...);
+    }
+
+    // at() z zapamiętaniem wyniku dla tych samych argumentów; opłaca się
+    // tylko dla często powtarzanych punktów
+    template <typename... Args>
+    detail::at_result_t<P, std::decay_t<Args>...> at_memoized(const Args &...args) const
+    {
+        using memo = detail::at_memo<P, std::decay_t<Args>...>;
+        return memo::instance().get(std::tuple<const P *, std::decay_t<Args>...>(p, args...),
+                                    [&] { return p->at(args...); });
+    }
+
+private:
+    const P *p = nullptr;
+
+    explicit interned(const P *p) : p(p) {}
+
+    template <typename Q>
+        requires(detail::is_poly_v<Q>)
+    friend class poly_intern_pool;
+};
+
+// uchwyt z globalnej puli typu P
+template <typename P>
+interned<P> intern(const P &p)
+{
+    return poly_intern_pool<P>::instance().intern(p);
+}
+
+// iloczyn internowanych wielomianów, liczony raz dla każdej pary
+template <typename P, typename Q>
+interned<detail::product_t<P, Q>> operator*(interned<P> a, interned<Q> b)
+{
+    using memo = detail::product_memo<P, Q>;
+    return memo::instance().get(std::tuple<const P *, const Q *>(&*a, &*b), [&] { return intern(*a * *b); });
+}
+
+template <typename P>
+struct std::hash<interned<P>>
+{
+    size_t operator()(interned<P> h) const noexcept { return std::hash<const P *>{}(h.operator->()); }
+};
+
+// Liczniki trafień tablic zapamiętanych wyników.
+struct poly_memo_stats
+{
+    size_t hits;
+    size_t misses;
+};
+
+template <typename P, typename Q>
+poly_memo_stats product_memo_stats()
+{
+    auto &m = detail::product_memo<P, Q>::instance();
+    return {m.hits(), m.misses()};
+}
+
+template <typename P, typename... Args>
+poly_memo_stats at_memo_stats()
+{
+    auto &m = detail::at_memo<P, Args...>::instance();
+    return {m.hits(), m.misses()};
+}
+
+// Czyszczenie i pojemność tablic zapamiętanych wyników.
+template <typename P, typename Q>
+void clear_product_memo()
+{
+    detail::product_memo<P, Q>::instance().clear();
+}
+
+template <typename P, typename... Args>
+void clear_at_memo()
+{
+    detail::at_memo<P, Args...>::instance().clear();
+}
+
+template <typename P, typename Q>
+void set_product_memo_capacity(size_t capacity)
+{
+    detail::product_memo<P, Q>::instance().set_capacity(capacity);
+}
+
+template <typename P, typename... Args>
+void set_at_memo_capacity(size_t capacity)
+{
+    detail::at_memo<P, Args...>::instance().set_capacity(capacity);
+}
+
+#endif // POLY_INTERN_H
@@ -0,0 +1,384 @@
+#ifndef POLY_INTERPOLATE_H
+#define POLY_INTERPOLATE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "poly.h"
+
+// Interpolacja: poly<T, N> o zadanych wartościach w N różnych punktach.
+// T musi być ciałem (double, std::complex, własny typ modularny).
+//
+// Dla dużych N używamy drzewa iloczynów m_v = prod (x - x_i): wagi
+// w_i = M'(x_i) liczy zejście po drzewie reszt (dzielenie przez odwrotność
+// szeregu Newtona), a wynik to przejście w górę
+//     f_v = f_lewy · m_prawy + f_prawy · m_lewy,   f_liść = y_i / w_i,
+// razem O(n log^2 n). Dla małych N szybsza jest gęsta macierz odwrotna do
+// macierzy Vandermonde'a, a dla pierwiastków z jedności odwrotna DFT.
+//
+// interpolation_grid przygotowuje wszystko, co zależy tylko od punktów, więc
+// kolejne interpolacje na tej samej siatce to już sama transformacja
+// wartości, bez dzieleń.
+
+namespace detail
+{
+    template <typename T>
+    struct is_complex : std::false_type
+    {
+    };
+
+    template <typename R>
+    struct is_complex<std::complex<R>> : std::true_type
+    {
+    };
+
+    // iloczyn wielomianów o współczynnikach w wektorach
+    template <typename T>
+    std::vector<T> vec_mul(const std::vector<T> &a, const std::vector<T> &b)
+    {
+        if (a.empty() || b.empty())
+            return {};
+        std::vector<T> out(a.size() + b.size() - 1);
+        if constexpr (fast_mul_v<T, T>)
+            mul_fast(a.data(), a.size(), b.data(), b.size(), out.data(), poly_tuning::karatsuba_cutoff);
+        else
+            mul_schoolbook(a.data(), a.size(), b.data(), b.size(), out.data());
+        return out;
+    }
+
+    // 1 / f mod x^k metodą Newtona: g <- g (2 - f g), podwajając dokładność
+    template <typename T>
+    std::vector<T> series_inverse(const std::vector<T> &f, size_t k)
+    {
+        std::vector<T> g{T(1) / f[0]};
+        while (g.size() < k)
+        {
+            size_t m = std::min(2 * g.size(), k);
+            std::vector<T> e = vec_mul(std::vector<T>(f.begin(), f.begin() + std::min(m, f.size())), g);
+            e.resize(m);
+            for (T &c : e)
+                c = -c;
+            e[0] += T(2);
+            g = vec_mul(g, e);
+            g.resize(m);
+        }
+        g.resize(k);
+        return g;
+    }
+
+    // wartość wielomianu w punkcie schematem Hornera
+    template <typename T>
+    T vec_at(const std::vector<T> &f, const T &x)
+    {
+        T acc = T();
+        for (size_t i = f.size(); i-- > 0;)
+            acc = acc * x + f[i];
+        return acc;
+    }
+}
+
+template <typename T, size_t N>
+    requires(N > 0)
+class interpolation_grid
+{
+public:
+    // do tego rozmiaru używamy gęstej macierzy N x N
+    static constexpr size_t dense_cutoff = 64;
+
+    explicit interpolation_grid(const std::array<T, N> &nodes) : x(nodes)
+    {
+        if constexpr (N <= dense_cutoff)
+            prepare_dense();
+        else
+            prepare_tree();
+    }
+
+    // węzły Czebyszewa na przedziale [lo, hi]
+    static interpolation_grid chebyshev(T lo, T hi)
+        requires(std::is_floating_point_v<T>)
+    {
+        std::array<T, N> nodes;
+        for (size_t k = 0; k < N; ++k)
+            nodes[k] = (lo + hi) / 2 +
+                       (hi - lo) / 2 * std::cos(std::numbers::pi_v<T> * T(2 * k + 1) / T(2 * N));
+        return interpolation_grid(nodes);
+    }
+
+    // x_k = exp(2 pi i k / N); dla N będącego potęgą dwójki interpolacja
+    // to odwrotna FFT
+    static interpolation_grid roots_of_unity()
+        requires(detail::is_complex<T>::value)
+    {
+        using R = typename T::value_type;
+        std::array<T, N> nodes;
+        for (size_t k = 0; k < N; ++k)
+            nodes[k] = std::polar(R(1), 2 * std::numbers::pi_v<R> * R(k) / R(N));
+        if constexpr ((N & (N - 1)) == 0)
+            return interpolation_grid(nodes, fourier_tag{});
+        else
+            return interpolation_grid(nodes);
+    }
+
+    const std::array<T, N> &nodes() const { return x; }
+
+    // wielomian stopnia < N o wartościach values[k] w nodes()[k]
+    poly<T, N> operator()(const T *values) const
+    {
+        poly<T, N> res;
+        switch (mode)
+        {
+        case method::dense:
+            for (size_t i = 0; i < N; ++i)
+            {
+                const T *row = dense.data() + i * N;
+                T sum = T();
+                for (size_t j = 0; j < N; ++j)
+                    sum += row[j] * values[j];
+                res[i] = sum;
+            }
+            break;
+        case method::fourier:
+            if constexpr (detail::is_complex<T>::value)
+                inverse_fft(values, res.data());
+            break;
+        case method::tree:
+        {
+            std::vector<T> scaled(N);
+            for (size_t k = 0; k < N; ++k)
+                scaled[k] = values[k] * inv_weight[k];
+            std::vector<T> f = combine(0, scaled.data());
+            for (size_t i = 0; i < N; ++i)
+                res[i] = f[i];
+            break;
+        }
+        }
+        return res;
+    }
+
+    poly<T, N> operator()(const std::array<T, N> &values) const
+    {
+        return (*this)(values.data());
+    }
+
+private:
+    enum class method
+    {
+        dense,
+        tree,
+        fourier
+    };
+
+    struct fourier_tag
+    {
+    };
+
+    struct node
+    {
+        size_t lo = 0, hi = 0;
+        size_t left = 0, right = 0;
+        // prod (x - x_i) dla i z [lo, hi), unormowany
+        std::vector<T> m;
+        // odwrotność odwróconego m do dokładności potrzebnej przy dzieleniu
+        // reszty rodzica (pusta, gdy wystarcza dzielenie szkolne)
+        std::vector<T> inv;
+    };
+
+    // poniżej tych rozmiarów dzielimy szkolnie i liczymy wartości Hornerem
+    static constexpr size_t division_cutoff = 32;
+    static constexpr size_t leaf_block = 8;
+
+    std::array<T, N> x;
+    method mode = method::dense;
+    // dense: macierz N x N, wierszami
+    std::vector<T> dense;
+    // tree: węzły (korzeń ma indeks 0) i odwrotności wag 1 / M'(x_i)
+    std::vector<node> tree;
+    std::vector<T> inv_weight;
+    // fourier: pierwiastki exp(-2 pi i k / N) dla k < N / 2
+    std::vector<T> twiddle;
+
+    interpolation_grid(const std::array<T, N> &nodes, fourier_tag) : x(nodes), mode(method::fourier)
+    {
+        twiddle.resize(N / 2);
+        for (size_t k = 0; k < N / 2; ++k)
+            twiddle[k] = std::conj(nodes[k]);
+    }
+
+    // Kolumna j to współczynniki wielomianu bazowego Lagrange'a
+    // (M / (x - x_j)) / w_j, gdzie w_j to wartość ilorazu w x_j.
+    void prepare_dense()
+    {
+        mode = method::dense;
+        std::vector<T> m{T(1)};
+        for (size_t k = 0; k < N; ++k)
+            m = detail::vec_mul(m, std::vector<T>{-x[k], T(1)});
+
+        dense.assign(N * N, T());
+        std::vector<T> q(N);
+        for (size_t j = 0; j < N; ++j)
+        {
+            // dzielenie syntetyczne przez (x - x_j)
+            q[N - 1] = m[N];
+            for (size_t i = N - 1; i-- > 0;)
+                q[i] = m[i + 1] + x[j] * q[i + 1];
+            T inv_w = T(1) / detail::vec_at(q, x[j]);
+            for (size_t i = 0; i < N; ++i)
+                dense[i * N + j] = q[i] * inv_w;
+        }
+    }
+
+    void prepare_tree()
+    {
+        mode = method::tree;
+        tree.reserve(2 * N - 1);
+        build(0, N);
+
+        // M' w punktach, zejściem po drzewie reszt
+        const std::vector<T> &m = tree[0].m;
+        std::vector<T> derivative(N);
+        for (size_t i = 1; i <= N; ++i)
+            derivative[i - 1] = m[i] * T(i);
+        inv_weight.resize(N);
+        evaluate(0, std::move(derivative), inv_weight.data());
+        for (T &w : inv_weight)
+            w = T(1) / w;
+    }
+
+    size_t build(size_t lo, size_t hi)
+    {
+        size_t id = tree.size();
+        tree.emplace_back();
+        tree[id].lo = lo;
+        tree[id].hi = hi;
+        if (hi - lo == 1)
+        {
+            tree[id].m = {-x[lo], T(1)};
+            return id;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        size_t left = build(lo, mid);
+        size_t right = build(mid, hi);
+        tree[id].left = left;
+        tree[id].right = right;
+        tree[id].m = detail::vec_mul(tree[left].m, tree[right].m);
+
+        // reszta modulo rodzic ma mniej niż hi - lo współczynników, więc
+        // iloraz przy dzieleniu przez dziecko ma ich najwyżej tyle, ile
+        // punktów ma rodzeństwo
+        for (auto [child, sibling] : {std::pair{left, right}, std::pair{right, left}})
+        {
+            node &c = tree[child];
+            size_t precision = tree[sibling].hi - tree[sibling].lo;
+            if (c.hi - c.lo > division_cutoff && precision > division_cutoff)
+            {
+                std::vector<T> rev(c.m.rbegin(), c.m.rend());
+                c.inv = detail::series_inverse(rev, precision);
+            }
+        }
+        return id;
+    }
+
+    // f mod m_v
+    std::vector<T> remainder(std::vector<T> f, const node &v) const
+    {
+        size_t d = v.m.size() - 1;
+        if (f.size() <= d)
+            return f;
+        size_t k = f.size() - d;
+        if (v.inv.empty())
+        {
+            // m_v jest unormowany, więc dzielenie szkolne nie dzieli
+            for (size_t i = f.size(); i-- > d;)
+            {
+                T q = f[i];
+                for (size_t j = 0; j < d; ++j)
+                    f[i - d + j] -= q * v.m[j];
+            }
+        }
+        else
+        {
+            // rev(q) = rev(f) · rev(m_v)^{-1} mod x^k
+            std::vector<T> rf(f.rbegin(), f.rbegin() + k);
+            std::vector<T> q = detail::vec_mul(rf, std::vector<T>(v.inv.begin(), v.inv.begin() + k));
+            q.resize(k);
+            std::reverse(q.begin(), q.end());
+            std::vector<T> qm = detail::vec_mul(q, v.m);
+            for (size_t i = 0; i < d; ++i)
+                f[i] -= qm[i];
+        }
+        f.resize(d);
+        return f;
+    }
+
+    // out[k] = f(x_k) dla punktów poddrzewa v; f ma stopień < liczba punktów
+    void evaluate(size_t id, std::vector<T> f, T *out) const
+    {
+        const node &v = tree[id];
+        if (v.hi - v.lo <= leaf_block)
+        {
+            for (size_t k = v.lo; k < v.hi; ++k)
+                out[k] = detail::vec_at(f, x[k]);
+            return;
+        }
+        evaluate(v.left, remainder(f, tree[v.left]), out);
+        evaluate(v.right, remainder(std::move(f), tree[v.right]), out);
+    }
+
+    // sum_{i w poddrzewie} c_i · prod_{j != i} (x - x_j)
+    std::vector<T> combine(size_t id, const T *c) const
+    {
+        const node &v = tree[id];
+        if (v.hi - v.lo == 1)
+            return {c[v.lo]};
+        std::vector<T> res = detail::vec_mul(combine(v.left, c), tree[v.right].m);
+        std::vector<T> other = detail::vec_mul(combine(v.right, c), tree[v.left].m);
+        for (size_t i = 0; i < res.size(); ++i)
+            res[i] += other[i];
+        return res;
+    }
+
+    // c_j = (1 / N) sum_k y_k exp(-2 pi i j k / N), iteracyjna FFT radix-2
+    void inverse_fft(const T *values, T *out) const
+    {
+        size_t bits = std::bit_width(N) - 1;
+        for (size_t k = 0; k < N; ++k)
+        {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; ++b)
+                r |= ((k >> b) & 1) << (bits - 1 - b);
+            out[r] = values[k];
+        }
+        for (size_t len = 2; len <= N; len *= 2)
+        {
+            size_t step = N / len;
+            for (size_t start = 0; start < N; start += len)
+                for (size_t j = 0; j < len / 2; ++j)
+                {
+                    T u = out[start + j];
+                    T v = out[start + j + len / 2] * twiddle[j * step];
+                    out[start + j] = u + v;
+                    out[start + j + len / 2] = u - v;
+                }
+        }
+        for (size_t k = 0; k < N; ++k)
+            out[k] /= typename T::value_type(N);
+    }
+};
+
+// Jednorazowa interpolacja; przy wielu interpolacjach na tych samych
+// punktach lepiej trzymać interpolation_grid.
+template <typename T, size_t N>
+poly<T, N> interpolate(const std::array<T, N> &nodes, const std::array<T, N> &values)
+{
+    return interpolation_grid<T, N>(nodes)(values);
+}
+
+#endif // POLY_INTERPOLATE_H
@@ -0,0 +1,314 @@
+#ifndef POLY_IO_H
+#define POLY_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "poly.h"
+
+// Binarny format banku wielomianów poly<T, N> (także zagnieżdżonych)
+// przeznaczony do mmap. Plik to nagłówek poly_file_header, a od data_offset
+// ciągła tablica count rekordów o układzie dokładnie takim jak w pamięci,
+// więc rekordy można czytać bez kopiowania jako const poly<T, N>&.
+
+class poly_file_error : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+enum class poly_scalar_kind : std::uint32_t
+{
+    int8 = 1, uint8, int16, uint16, int32, uint32, int64, uint64, float32, float64
+};
+
+struct poly_file_header
+{
+    static constexpr char magic_value[8] = {'P', 'O', 'L', 'Y', 'B', 'N', 'K', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t endian_tag = 0x01020304;
+    static constexpr size_t max_depth = 8;
+    static constexpr size_t data_alignment = 64;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint32_t endian;
+    std::uint32_t scalar_kind;
+    std::uint32_t scalar_size;
+    std::uint32_t depth;
+    // shape[0] to rozmiar zewnętrznego wielomianu, shape[depth - 1] najgłębszego
+    std::uint64_t shape[max_depth];
+    std::uint64_t record_size;
+    std::uint64_t count;
+    std::uint64_t data_offset;
+    // FNV-1a z poprzednich pól
+    std::uint64_t checksum;
+};
+
+namespace detail
+{
+    template <typename U>
+    constexpr poly_scalar_kind scalar_kind()
+    {
+        if constexpr (std::is_same_v<U, float>)
+            return poly_scalar_kind::float32;
+        else if constexpr (std::is_same_v<U, double>)
+            return poly_scalar_kind::float64;
+        else
+        {
+            static_assert(std::is_integral_v<U> && !std::is_same_v<U, bool>,
+                          "poly_io obsługuje tylko liczby całkowite, float i double");
+            constexpr poly_scalar_kind kinds[] = {
+                poly_scalar_kind::int8, poly_scalar_kind::uint8, poly_scalar_kind::int16, poly_scalar_kind::uint16,
+                poly_scalar_kind::int32, poly_scalar_kind::uint32, poly_scalar_kind::int64, poly_scalar_kind::uint64};
+            size_t log = sizeof(U) == 1 ? 0 : sizeof(U) == 2 ? 1 : sizeof(U) == 4 ? 2 : 3;
+            return kinds[2 * log + (std::is_unsigned_v<U> ? 1 : 0)];
+        }
+    }
+
+    // rozmiary kolejnych poziomów zagnieżdżenia
+    template <typename P>
+    struct poly_shape
+    {
+        static constexpr size_t elements = 1;
+        static constexpr void fill(std::uint64_t *) {}
+    };
+
+    template <typename U, size_t M, typename S>
+    struct poly_shape<poly<U, M, S>>
+    {
+        static constexpr size_t elements = M * poly_shape<U>::elements;
+        static constexpr void fill(std::uint64_t *out)
+        {
+            out[0] = M;
+            poly_shape<U>::fill(out + 1);
+        }
+    };
+
+    // Typ da się zmapować, jeśli jest gęstą tablicą skalarów bez wskaźników.
+    template <typename P>
+    inline constexpr bool mappable_v =
+        is_poly_v<P> && std::is_trivially_copyable_v<P> && std::is_standard_layout_v<P> &&
+        poly_depth_v<P> <= poly_file_header::max_depth &&
+        sizeof(P) == poly_shape<P>::elements * sizeof(poly_scalar_t<P>);
+
+    inline std::uint64_t header_checksum(const poly_file_header &h)
+    {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(&h);
+        std::uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < offsetof(poly_file_header, checksum); ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        return hash;
+    }
+
+    template <typename P>
+    poly_file_header make_header(std::uint64_t count)
+    {
+        poly_file_header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, poly_file_header::magic_value, sizeof(h.magic));
+        h.version = poly_file_header::current_version;
+        h.header_size = sizeof(poly_file_header);
+        h.endian = poly_file_header::endian_tag;
+        h.scalar_kind = static_cast<std::uint32_t>(scalar_kind<poly_scalar_t<P>>());
+        h.scalar_size = sizeof(poly_scalar_t<P>);
+        h.depth = poly_depth_v<P>;
+        poly_shape<P>::fill(h.shape);
+        h.record_size = sizeof(P);
+        h.count = count;
+        h.data_offset = (sizeof(poly_file_header) + poly_file_header::data_alignment - 1) /
+                        poly_file_header::data_alignment * poly_file_header::data_alignment;
+        h.checksum = header_checksum(h);
+        return h;
+    }
+}
+
+// Sprawdza, czy nagłówek opisuje bank typu P mieszczący się w pliku
+// rozmiaru file_size. Koszt nie zależy od liczby rekordów. Zwraca opis
+// błędu albo nullptr.
+template <typename P>
+const char *check_poly_file(const poly_file_header &h, std::uint64_t file_size)
+{
+    poly_file_header expected = detail::make_header<P>(h.count);
+    if (std::memcmp(h.magic, poly_file_header::magic_value, sizeof(h.magic)) != 0)
+        return "not a poly bank file";
+    if (h.version != poly_file_header::current_version)
+        return "unsupported format version";
+    if (h.endian != poly_file_header::endian_tag)
+        return "byte order mismatch";
+    if (h.checksum != detail::header_checksum(h))
+        return "corrupted header";
+    if (h.header_size != expected.header_size || h.data_offset != expected.data_offset)
+        return "unexpected header layout";
+    if (h.scalar_kind != expected.scalar_kind || h.scalar_size != expected.scalar_size)
+        return "coefficient type mismatch";
+    if (h.depth != expected.depth || std::memcmp(h.shape, expected.shape, sizeof(h.shape)) != 0 ||
+        h.record_size != expected.record_size)
+        return "polynomial shape mismatch";
+    if (file_size < h.data_offset || (file_size - h.data_offset) / h.record_size < h.count)
+        return "file is truncated";
+    return nullptr;
+}
+
+// ZAPIS
+// Strumieniowy zapis banku: rekordy dopisywane są na bieżąco, a liczba
+// rekordów trafia do nagłówka w close().
+template <typename P>
+    requires(detail::mappable_v<P>)
+class poly_bank_writer
+{
+public:
+    explicit poly_bank_writer(const std::string &path) : file(std::fopen(path.c_str(), "wb"))
+    {
+        if (file == nullptr)
+            throw poly_file_error("cannot open " + path + " for writing");
+        // po wyjątku z konstruktora destruktor się nie wykona - plik
+        // zamykamy sami
+        try
+        {
+            poly_file_header h = detail::make_header<P>(0);
+            write_bytes(&h, sizeof(h));
+            static const char zeros[poly_file_header::data_alignment] = {};
+            write_bytes(zeros, h.data_offset - sizeof(h));
+        }
+        catch (...)
+        {
+            std::fclose(file);
+            throw;
+        }
+    }
+
+    poly_bank_writer(const poly_bank_writer &) = delete;
+    poly_bank_writer &operator=(const poly_bank_writer &) = delete;
+
+    ~poly_bank_writer()
+    {
+        if (file != nullptr)
+        {
+            // błędów nie da się tu zgłosić; kto chce je obsłużyć, woła close()
+            try
+            {
+                finish();
+            }
+            catch (const poly_file_error &)
+            {
+            }
+            std::fclose(file);
+        }
+    }
+
+    void write(const P &p)
+    {
+        write_bytes(&p, sizeof(P));
+        ++count;
+    }
+
+    void write(const P *first, size_t n)
+    {
+        write_bytes(first, n * sizeof(P));
+        count += n;
+    }
+
+    // Uzupełnia nagłówek i zamyka plik.
+    void close()
+    {
+        finish();
+        int status = std::fclose(std::exchange(file, nullptr));
+        if (status != 0)
+            throw poly_file_error("cannot close poly bank file");
+    }
+
+    std::uint64_t size() const { return count; }
+
+private:
+    std::FILE *file;
+    std::uint64_t count = 0;
+
+    void write_bytes(const void *data, size_t bytes)
+    {
+        if (bytes != 0 && std::fwrite(data, 1, bytes, file) != bytes)
+            throw poly_file_error("write to poly bank file failed");
+    }
+
+    void finish()
+    {
+        poly_file_header h = detail::make_header<P>(count);
+        if (std::fseek(file, 0, SEEK_SET) != 0)
+            throw poly_file_error("cannot rewind poly bank file");
+        write_bytes(&h, sizeof(h));
+        std::fflush(file);
+    }
+};
+
+// ODCZYT
+// Bank zmapowany w pamięci: rekordy są widoczne bezpośrednio jako const P&.
+template <typename P>
+    requires(detail::mappable_v<P>)
+class mapped_poly_bank
+{
+public:
+    explicit mapped_poly_bank(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw poly_file_error("cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(poly_file_header))
+        {
+            ::close(fd);
+            throw poly_file_error(path + ": file is too small");
+        }
+        length = static_cast<size_t>(st.st_size);
+        void *mem = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED)
+            throw poly_file_error("cannot map " + path);
+        base = static_cast<const std::byte *>(mem);
+
+        const char *error = check_poly_file<P>(header(), length);
+        if (error != nullptr)
+        {
+            ::munmap(const_cast<std::byte *>(base), length);
+            throw poly_file_error(path + ": " + error);
+        }
+        records = reinterpret_cast<const P *>(base + header().data_offset);
+    }
+
+    mapped_poly_bank(mapped_poly_bank &&other) noexcept
+        : base(std::exchange(other.base, nullptr)), length(other.length), records(other.records) {}
+
+    mapped_poly_bank(const mapped_poly_bank &) = delete;
+    mapped_poly_bank &operator=(const mapped_poly_bank &) = delete;
+
+    ~mapped_poly_bank()
+    {
+        if (base != nullptr)
+            ::munmap(const_cast<std::byte *>(base), length);
+    }
+
+    const poly_file_header &header() const { return *reinterpret_cast<const poly_file_header *>(base); }
+
+    size_t size() const { return header().count; }
+    const P &operator[](size_t i) const { return records[i]; }
+    const P *begin() const { return records; }
+    const P *end() const { return records + size(); }
+
+private:
+    const std::byte *base;
+    size_t length;
+    const P *records;
+};
+
+#endif // POLY_IO_H
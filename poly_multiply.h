@@ -0,0 +1,385 @@
+#ifndef POLY_MULTIPLY_H
+#define POLY_MULTIPLY_H
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef POLY_PARALLEL
+#include "poly_parallel.h"
+#endif
+
+// Progi przełączania algorytmów mnożenia. Wartości można zmienić w czasie
+// działania programu, np. po pomiarach na danej maszynie.
+struct poly_tuning
+{
+    // Karatsuba zamiast mnożenia szkolnego, gdy krótszy czynnik ma więcej
+    // współczynników niż karatsuba_cutoff
+    inline static size_t karatsuba_cutoff = 32;
+    // gałęzie Karatsuby jako osobne zadania puli wątków (tylko przy POLY_PARALLEL),
+    // gdy mnożone połowy mają co najmniej parallel_cutoff współczynników
+    inline static size_t parallel_cutoff = 2048;
+    // próg Karatsuby w czasie kompilacji; niski, bo tam liczy się liczba
+    // kroków interpretera, a nie czas procesora
+    static constexpr size_t constexpr_karatsuba_cutoff = 16;
+    // iloczyny wielomianów zmiennoprzecinkowych o obu rozmiarach nie większych
+    // niż unroll_limit liczymy w pełni rozwiniętym kodem (small_product)
+    static constexpr size_t unroll_limit = 16;
+    // at() dla współczynników liczbowych liczy schematem Estrina zamiast
+    // Hornera od tylu współczynników wzwyż; domyślnie zawsze Horner
+    // (zob. poly_autotune.h)
+    inline static size_t estrin_cutoff = std::numeric_limits<size_t>::max();
+};
+
+namespace detail
+{
+    // szybkie mnożenie stosujemy tylko do współczynników liczbowych
+    template <typename T, typename U>
+    inline constexpr bool fast_mul_v = std::is_arithmetic_v<T> && std::is_arithmetic_v<U> &&
+                                       !std::is_same_v<T, bool> && !std::is_same_v<U, bool>;
+
+    // a * b + c; jednym rozkazem FMA, gdy procesor go ma (FP_FAST_FMA*),
+    // inaczej - i w czasie kompilacji - zwykłym mnożeniem i dodawaniem
+    template <typename R>
+    constexpr R fmadd(const R &a, const R &b, const R &c)
+    {
+        if (!std::is_constant_evaluated())
+        {
+#ifdef FP_FAST_FMA
+            if constexpr (std::is_same_v<R, double>)
+                return std::fma(a, b, c);
+#endif
+#ifdef FP_FAST_FMAF
+            if constexpr (std::is_same_v<R, float>)
+                return std::fma(a, b, c);
+#endif
+#ifdef FP_FAST_FMAL
+            if constexpr (std::is_same_v<R, long double>)
+                return std::fma(a, b, c);
+#endif
+        }
+        return a * b + c;
+    }
+
+    // małe iloczyny zmiennoprzecinkowe rozwijamy w całości
+    template <typename T, typename U, size_t N, size_t M>
+    inline constexpr bool small_product_v = std::is_floating_point_v<T> && std::is_same_v<T, U> &&
+                                            N <= poly_tuning::unroll_limit && M <= poly_tuning::unroll_limit;
+
+    // K-ty współczynnik iloczynu: suma a[i] b[K - i] po kolejnych i od lo,
+    // w tej samej kolejności co w mnożeniu szkolnym
+    template <size_t K, size_t Lo, typename R, size_t... J>
+    constexpr R small_coefficient(const R *a, const R *b, std::index_sequence<0, J...>)
+    {
+        R acc = a[Lo] * b[K - Lo];
+        ((acc = fmadd(a[Lo + J], b[K - Lo - J], acc)), ...);
+        return acc;
+    }
+
+    template <size_t N, size_t M, typename R, size_t... K>
+    constexpr void small_product(const R *a, const R *b, R *out, std::index_sequence<K...>)
+    {
+        ((out[K] = small_coefficient<K, (K + 1 > M ? K + 1 - M : 0)>(
+              a, b, std::make_index_sequence<std::min(K, N - 1) + 1 - (K + 1 > M ? K + 1 - M : 0)>())),
+         ...);
+    }
+
+    // out[0 .. N + M - 1) = a * b bez pętli i bez zerowania out
+    template <size_t N, size_t M, typename R>
+    constexpr void small_product(const R *a, const R *b, R *out)
+    {
+        small_product<N, M>(a, b, out, std::make_index_sequence<N + M - 1>());
+    }
+
+    // out[0 .. n + m - 1) = a * b, mnożenie szkolne
+    template <typename R>
+    constexpr void mul_schoolbook(const R *a, size_t n, const R *b, size_t m, R *out)
+    {
+        std::fill(out, out + n + m - 1, R());
+        for (size_t i = 0; i < n; ++i)
+        {
+            const R ai = a[i];
+            R *row = out + i;
+            for (size_t j = 0; j < m; ++j)
+                row[j] += ai * b[j];
+        }
+    }
+
+    // out[0 .. 2n - 1) = a * a; iloczyny a[i] a[j] dla i != j liczymy raz
+    template <typename R>
+    constexpr void sqr_schoolbook(const R *a, size_t n, R *out)
+    {
+        std::fill(out, out + 2 * n - 1, R());
+        for (size_t i = 0; i < n; ++i)
+        {
+            const R ai = a[i];
+            R *row = out + i;
+            for (size_t j = i + 1; j < n; ++j)
+                row[j] += ai * a[j];
+        }
+        for (size_t k = 0; k < 2 * n - 1; ++k)
+            out[k] += out[k];
+        for (size_t i = 0; i < n; ++i)
+            out[2 * i] += a[i] * a[i];
+    }
+
+    // Złożenie kroku Karatsuby: out zawiera iloczyny dolny (2m - 1) i górny
+    // (2h - 1, od 2m), mid - iloczyn sum; mid jest niszczone.
+    template <typename R>
+    constexpr void karatsuba_combine(R *out, R *mid, size_t m, size_t h)
+    {
+        // out[2m - 1] leży między iloczynami dolnym i górnym
+        if (m > 0)
+            out[2 * m - 1] = R();
+        for (size_t i = 0; i + 1 < 2 * m; ++i)
+            mid[i] -= out[i];
+        for (size_t i = 0; i + 1 < 2 * h; ++i)
+            mid[i] -= out[2 * m + i];
+        for (size_t i = 0; i + 1 < 2 * h; ++i)
+            out[m + i] += mid[i];
+    }
+
+    // Rozmiar pamięci pomocniczej dla karatsuba() przy czynnikach długości n.
+    constexpr size_t karatsuba_scratch(size_t n, size_t cutoff)
+    {
+        size_t total = 0;
+        while (n > cutoff)
+        {
+            size_t h = n - n / 2;
+            total += 4 * h;
+            n = h;
+        }
+        return total;
+    }
+
+    // out[0 .. 2n - 1) = a * b dla czynników tej samej długości n.
+    // scratch musi mieć co najmniej karatsuba_scratch(n, cutoff) elementów.
+    // Dla a == b wszystkie podproblemy są kwadratami.
+    template <typename R>
+    constexpr void karatsuba(const R *a, const R *b, size_t n, R *out, R *scratch, size_t cutoff)
+    {
+        bool square = a == b;
+        if (n <= cutoff)
+        {
+            if (square)
+                sqr_schoolbook(a, n, out);
+            else
+                mul_schoolbook(a, n, b, n, out);
+            return;
+        }
+
+        // a = a_lo + x^m a_hi, gdzie a_hi ma h >= m współczynników
+        size_t m = n / 2;
+        size_t h = n - m;
+        R *sa = scratch;
+        R *sb = sa + h;
+        R *mid = sb + h;
+        R *rest = mid + 2 * h;
+
+        for (size_t i = 0; i < h; ++i)
+            sa[i] = a[m + i];
+        for (size_t i = 0; i < m; ++i)
+            sa[i] += a[i];
+        if (square)
+            sb = sa;
+        else
+        {
+            for (size_t i = 0; i < h; ++i)
+                sb[i] = b[m + i];
+            for (size_t i = 0; i < m; ++i)
+                sb[i] += b[i];
+        }
+
+#ifdef POLY_PARALLEL
+        if (!std::is_constant_evaluated() && m >= poly_tuning::parallel_cutoff &&
+            poly_thread_pool::instance().size() > 1)
+        {
+            // każda gałąź dostaje własną pamięć pomocniczą
+            size_t need = karatsuba_scratch(h, cutoff);
+            std::vector<R> tmp_low(need), tmp_high(need);
+            poly_thread_pool::instance().invoke(
+                [&] { karatsuba(sa, sb, h, mid, rest, cutoff); },
+                [&] { karatsuba(a, b, m, out, tmp_low.data(), cutoff); },
+                [&] { karatsuba(a + m, b + m, h, out + 2 * m, tmp_high.data(), cutoff); });
+        }
+        else
+#endif
+        {
+            karatsuba(a, b, m, out, rest, cutoff);
+            karatsuba(a + m, b + m, h, out + 2 * m, rest, cutoff);
+            karatsuba(sa, sb, h, mid, rest, cutoff);
+        }
+
+        karatsuba_combine(out, mid, m, h);
+    }
+
+    // Rozmiary drzew podziałów Karatsuby (karatsuba_prepare) dla długości
+    // 0 .. n: sizes[k] dla czynnika długości k. Liczone raz, żeby węzły
+    // rekursji znajdowały poddrzewa bez ponownego przechodzenia po nich.
+    constexpr void karatsuba_tree_sizes(size_t n, size_t cutoff, size_t *sizes)
+    {
+        for (size_t k = 0; k <= n; ++k)
+            sizes[k] = k <= cutoff ? 0 : (k - k / 2) + sizes[k / 2] + 2 * sizes[k - k / 2];
+    }
+
+    // Drzewo podziałów czynnika b długości n: sumy b_lo + b_hi z każdego
+    // węzła rekursji karatsuba(). Węzeł to sumy (h elementów), a po nich
+    // poddrzewa dolnej połowy, górnej połowy i samych sum.
+    template <typename R>
+    constexpr void karatsuba_prepare(const R *b, size_t n, R *tree, const size_t *sizes, size_t cutoff)
+    {
+        if (n <= cutoff)
+            return;
+        size_t m = n / 2;
+        size_t h = n - m;
+        for (size_t i = 0; i < h; ++i)
+            tree[i] = b[m + i];
+        for (size_t i = 0; i < m; ++i)
+            tree[i] += b[i];
+        R *low = tree + h;
+        R *high = low + sizes[m];
+        R *mid = high + sizes[h];
+        karatsuba_prepare(b, m, low, sizes, cutoff);
+        karatsuba_prepare(b + m, h, high, sizes, cutoff);
+        karatsuba_prepare(tree, h, mid, sizes, cutoff);
+    }
+
+    // Jak karatsuba(), ale sumy drugiego czynnika bierzemy z jego drzewa
+    // podziałów (karatsuba_prepare z tymi samymi sizes i cutoff), więc
+    // liczymy tylko stronę a. scratch jak dla karatsuba().
+    template <typename R>
+    constexpr void karatsuba_prepared(const R *a, const R *b, const R *tree, const size_t *sizes, size_t n, R *out,
+                                      R *scratch, size_t cutoff)
+    {
+        if (n == 0)
+            return;
+        if (n <= cutoff)
+        {
+            mul_schoolbook(a, n, b, n, out);
+            return;
+        }
+
+        size_t m = n / 2;
+        size_t h = n - m;
+        R *sa = scratch;
+        R *mid = sa + h;
+        R *rest = mid + 2 * h;
+
+        for (size_t i = 0; i < h; ++i)
+            sa[i] = a[m + i];
+        for (size_t i = 0; i < m; ++i)
+            sa[i] += a[i];
+
+        const R *sb = tree;
+        const R *low = tree + h;
+        const R *high = low + sizes[m];
+        const R *sums = high + sizes[h];
+        karatsuba_prepared(a, b, low, sizes, m, out, rest, cutoff);
+        karatsuba_prepared(a + m, b + m, high, sizes, h, out + 2 * m, rest, cutoff);
+        karatsuba_prepared(sa, sb, sums, sizes, h, mid, rest, cutoff);
+
+        karatsuba_combine(out, mid, m, h);
+    }
+
+    // Rozmiar pamięci pomocniczej dla mul_prepared() przy drugim czynniku
+    // długości m.
+    constexpr size_t mul_prepared_scratch(size_t m, size_t cutoff)
+    {
+        return karatsuba_scratch(m, cutoff) + m + 2 * m - 1;
+    }
+
+    // out[0 .. n + m - 1) = a * b dla n >= m, gdzie tree to drzewo podziałów
+    // b. Czynnik a dzielimy na kawałki długości m, jak w mul_fast(). scratch
+    // musi mieć co najmniej mul_prepared_scratch(m, cutoff) elementów.
+    template <typename R>
+    constexpr void mul_prepared(const R *a, size_t n, const R *b, size_t m, const R *tree, const size_t *sizes,
+                                R *out, R *scratch, size_t cutoff)
+    {
+        if (n == m)
+        {
+            karatsuba_prepared(a, b, tree, sizes, m, out, scratch, cutoff);
+            return;
+        }
+        R *chunk = scratch + karatsuba_scratch(m, cutoff);
+        R *part = chunk + m;
+        std::fill(out, out + n + m - 1, R());
+        for (size_t start = 0; start < n; start += m)
+        {
+            size_t len = std::min(m, n - start);
+            std::copy(a + start, a + start + len, chunk);
+            std::fill(chunk + len, chunk + m, R());
+            karatsuba_prepared(chunk, b, tree, sizes, m, part, scratch, cutoff);
+            for (size_t i = 0; i < len + m - 1; ++i)
+                out[start + i] += part[i];
+        }
+    }
+
+    // out[0 .. n + m - 1) = a * b dla dowolnych długości. Dłuższy czynnik
+    // dzielimy na kawałki długości krótszego i mnożymy Karatsubą.
+    // Działa także w czasie kompilacji.
+    template <typename R>
+    constexpr void mul_fast(const R *a, size_t n, const R *b, size_t m, R *out, size_t cutoff)
+    {
+        if (n < m)
+        {
+            std::swap(a, b);
+            std::swap(n, m);
+        }
+        cutoff = std::max<size_t>(cutoff, 1);
+        if (m <= cutoff)
+        {
+            mul_schoolbook(a, n, b, m, out);
+            return;
+        }
+
+        std::vector<R> scratch(karatsuba_scratch(m, cutoff));
+        if (n == m)
+        {
+            karatsuba(a, b, m, out, scratch.data(), cutoff);
+            return;
+        }
+        std::vector<R> chunk(m), part(2 * m - 1);
+        std::fill(out, out + n + m - 1, R());
+        for (size_t start = 0; start < n; start += m)
+        {
+            size_t len = std::min(m, n - start);
+            std::copy(a + start, a + start + len, chunk.begin());
+            std::fill(chunk.begin() + len, chunk.end(), R());
+            karatsuba(chunk.data(), b, m, part.data(), scratch.data(), cutoff);
+            for (size_t i = 0; i < len + m - 1; ++i)
+                out[start + i] += part[i];
+        }
+    }
+
+    // Mnożenie współczynników dowolnych typów liczbowych: najpierw
+    // konwersja do typu wyniku R, potem mul_fast.
+    template <typename R, typename T, typename U>
+    constexpr void mul_fast_convert(const T *a, size_t n, const U *b, size_t m, R *out, size_t cutoff)
+    {
+        if constexpr (std::is_same_v<T, R> && std::is_same_v<U, R>)
+            mul_fast(a, n, b, m, out, cutoff);
+        else if constexpr (std::is_same_v<T, U>)
+        {
+            // kwadrat zostaje kwadratem także po konwersji
+            std::vector<R> ra(a, a + n);
+            if (a == b && n == m)
+                mul_fast(ra.data(), n, ra.data(), n, out, cutoff);
+            else
+            {
+                std::vector<R> rb(b, b + m);
+                mul_fast(ra.data(), n, rb.data(), m, out, cutoff);
+            }
+        }
+        else
+        {
+            std::vector<R> ra(a, a + n), rb(b, b + m);
+            mul_fast(ra.data(), n, rb.data(), m, out, cutoff);
+        }
+    }
+}
+
+#endif // POLY_MULTIPLY_H
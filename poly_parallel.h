@@ -0,0 +1,228 @@
+#ifndef POLY_PARALLEL_H
+#define POLY_PARALLEL_H
+
+#include <cassert>
+#include <cstddef>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pula wątków z podkradaniem zadań, używana przez równoległe mnożenie dużych
+// wielomianów. Każdy wątek ma własną kolejkę: swoje zadania zdejmuje z końca,
+// a cudze podkrada z początku. Wątek czekający na zadania potomne sam je
+// wykonuje, więc zagnieżdżone fork-join nie blokuje puli.
+class poly_thread_pool
+{
+public:
+    explicit poly_thread_pool(unsigned threads = std::thread::hardware_concurrency())
+        : queues(threads == 0 ? 1 : threads)
+    {
+        for (unsigned i = 0; i < queues.size(); ++i)
+            workers.emplace_back([this, i] { work(i); });
+    }
+
+    poly_thread_pool(const poly_thread_pool &) = delete;
+    poly_thread_pool &operator=(const poly_thread_pool &) = delete;
+
+    ~poly_thread_pool()
+    {
+        {
+            std::lock_guard lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    // Pula współdzielona przez wszystkie wywołania operator*. Liczba wątków
+    // ma znaczenie tylko przy pierwszym wywołaniu, które tworzy pulę;
+    // późniejsze mogą podać 0 albo tę samą liczbę.
+    static poly_thread_pool &instance(unsigned threads = 0)
+    {
+        static poly_thread_pool pool(threads == 0 ? std::thread::hardware_concurrency() : threads);
+        assert(threads == 0 || threads == pool.size());
+        return pool;
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Grupa zadań, na których zakończenie można poczekać. Wyjątek z zadania
+    // nie przerywa pozostałych; wait() zgłasza pierwszy z nich po
+    // zakończeniu wszystkich.
+    class task_group
+    {
+    public:
+        explicit task_group(poly_thread_pool &pool) : pool(pool) {}
+        // destruktor tylko czeka; wyjątki odbiera wait()
+        ~task_group() { join(); }
+
+        template <typename F>
+        void spawn(F &&f)
+        {
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.push([this, f = std::forward<F>(f)]() mutable {
+                try
+                {
+                    f();
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(error_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+                pending.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        void wait()
+        {
+            join();
+            std::exception_ptr e;
+            {
+                std::lock_guard lock(error_mutex);
+                std::swap(e, error);
+            }
+            if (e)
+                std::rethrow_exception(e);
+        }
+
+    private:
+        poly_thread_pool &pool;
+        std::atomic<size_t> pending{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        void join()
+        {
+            while (pending.load(std::memory_order_acquire) != 0)
+                if (!pool.run_one())
+                    std::this_thread::yield();
+        }
+    };
+
+    // Wykonuje wszystkie funkcje równolegle i czeka na ich zakończenie.
+    template <typename F, typename... Fs>
+    void invoke(F &&first, Fs &&...rest)
+    {
+        task_group group(*this);
+        (group.spawn(std::forward<Fs>(rest)), ...);
+        first();
+        group.wait();
+    }
+
+private:
+    using task = std::function<void()>;
+
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    std::vector<queue> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{0};
+    bool stopping = false;
+
+    struct worker_id
+    {
+        const poly_thread_pool *pool = nullptr;
+        int index = -1;
+    };
+
+    static worker_id &current_worker()
+    {
+        thread_local worker_id id;
+        return id;
+    }
+
+    // indeks wątku tej puli albo -1 dla wątków spoza niej
+    int worker_index() const
+    {
+        return current_worker().pool == this ? current_worker().index : -1;
+    }
+
+    void push(task t)
+    {
+        int self = worker_index();
+        size_t q = self >= 0 ? static_cast<size_t>(self) : next_external++ % queues.size();
+        {
+            std::lock_guard lock(queues[q].mutex);
+            queues[q].tasks.push_back(std::move(t));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            // bez tego śpiący wątek mógłby przegapić powiadomienie
+            std::lock_guard lock(sleep_mutex);
+        }
+        wake.notify_one();
+    }
+
+    bool pop(task &t)
+    {
+        int self = worker_index();
+        size_t n = queues.size();
+        if (self >= 0)
+        {
+            auto &own = queues[self];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                t = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+        for (size_t k = 0; k < n; ++k)
+        {
+            auto &victim = queues[(start + k) % n];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                t = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool run_one()
+    {
+        task t;
+        if (!pop(t))
+            return false;
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        t();
+        return true;
+    }
+
+    void work(unsigned index)
+    {
+        current_worker() = {this, static_cast<int>(index)};
+        while (true)
+        {
+            if (run_one())
+                continue;
+            std::unique_lock lock(sleep_mutex);
+            wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) != 0; });
+            if (stopping)
+                return;
+        }
+    }
+
+    std::atomic<size_t> next_external{0};
+};
+
+#endif // POLY_PARALLEL_H
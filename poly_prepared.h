@@ -0,0 +1,130 @@
+#ifndef POLY_PREPARED_H
+#define POLY_PREPARED_H
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "poly.h"
+
+// Czynnik przygotowany do wielokrotnego mnożenia, np. stałe jądro filtru
+// mnożone przez tysiące różnych wielomianów:
+//
+//     prepared<poly<double, 256>> kernel(k);
+//     auto y = x * kernel;     // ten sam wynik co x * k
+//
+// Przy konstrukcji liczymy raz drzewo podziałów Karatsuby jądra (sumy połówek
+// z każdego poziomu rekursji), więc iloczyn liczy już tylko stronę drugiego
+// czynnika. Dotyczy współczynników liczbowych, jądra dłuższego niż próg
+// Karatsuby z chwili przygotowania i drugiego czynnika nie krótszego niż
+// jądro; pozostałe iloczyny to zwykłe operator*.
+//
+// Dla ring_poly odpowiednikiem jest trzymanie jądra w dziedzinie NTT
+// (to_ntt()) - wtedy mnożenie przekształca tylko drugi czynnik.
+
+template <typename P>
+class prepared;
+
+namespace detail
+{
+    // Pamięć pomocnicza iloczynów z przygotowanym czynnikiem, jedna na wątek
+    // i typ, żeby iloczyny nie alokowały za każdym razem, a jeden prepared
+    // mógł być używany z wielu wątków naraz.
+    template <typename T>
+    T *prepared_workspace(size_t size)
+    {
+        thread_local std::vector<T> buffer;
+        if (buffer.size() < size)
+            buffer.resize(size);
+        return buffer.data();
+    }
+}
+
+template <typename T, size_t M, typename S>
+class prepared<poly<T, M, S>>
+{
+public:
+    constexpr explicit prepared(poly<T, M, S> kernel)
+        : kernel(std::move(kernel)),
+          cutoff(std::is_constant_evaluated() ? poly_tuning::constexpr_karatsuba_cutoff : poly_tuning::karatsuba_cutoff)
+    {
+        cutoff = std::max<size_t>(cutoff, 1);
+        if constexpr (detail::fast_mul_v<T, T> && M > 0)
+            if (M > cutoff)
+            {
+                sizes.resize(M + 1);
+                detail::karatsuba_tree_sizes(M, cutoff, sizes.data());
+                tree.resize(sizes[M]);
+                detail::karatsuba_prepare(this->kernel.data(), M, tree.data(), sizes.data(), cutoff);
+            }
+    }
+
+    constexpr const poly<T, M, S> &get() const { return kernel; }
+    constexpr const poly<T, M, S> &operator*() const { return kernel; }
+
+    template <typename U, size_t N, typename SU>
+        requires requires(const poly<U, N, SU> &x, const poly<T, M, S> &y) { x * y; }
+    friend constexpr auto operator*(const poly<U, N, SU> &x, const prepared &k)
+    {
+        using R = std::remove_cvref_t<decltype(x * k.kernel)>;
+        if constexpr (detail::fast_mul_v<U, T> && std::is_same_v<typename R::value_type, T> && N >= M && M > 0)
+        {
+            if (!k.tree.empty())
+            {
+                [[maybe_unused]] detail::op_observer_t<U> observe(
+                    detail::op_site_v<detail::poly_op::multiply, poly<U, N, SU>, poly<T, M, S>>);
+                R res;
+                // pamięć pomocnicza, a przy innym typie U także x po konwersji
+                size_t need = detail::mul_prepared_scratch(M, k.cutoff) + (std::is_same_v<U, T> ? 0 : N);
+                std::vector<T> local;
+                T *scratch;
+                if (std::is_constant_evaluated())
+                {
+                    local.resize(need);
+                    scratch = local.data();
+                }
+                else
+                    scratch = detail::prepared_workspace<T>(need);
+                const T *a;
+                if constexpr (std::is_same_v<U, T>)
+                    a = x.data();
+                else
+                {
+                    T *converted = scratch + (need - N);
+                    std::copy(x.data(), x.data() + N, converted);
+                    a = converted;
+                }
+                detail::mul_prepared(a, N, k.kernel.data(), M, k.tree.data(), k.sizes.data(), res.data(), scratch,
+                                     k.cutoff);
+                return res;
+            }
+        }
+        return x * k.kernel;
+    }
+
+    // mnożenie jest przemienne
+    template <typename U, size_t N, typename SU>
+        requires requires(const poly<U, N, SU> &x, const poly<T, M, S> &y) { x * y; }
+    friend constexpr auto operator*(const prepared &k, const poly<U, N, SU> &x)
+    {
+        if constexpr (detail::fast_mul_v<U, T>)
+            return x * k;
+        else
+            return k.kernel * x;
+    }
+
+private:
+    poly<T, M, S> kernel;
+    // próg Karatsuby, z którym zbudowano drzewo
+    size_t cutoff;
+    std::vector<T> tree;
+    // rozmiary poddrzew dla długości 0 .. M (detail::karatsuba_tree_sizes)
+    std::vector<size_t> sizes;
+};
+
+template <typename T, size_t M, typename S>
+prepared(poly<T, M, S>) -> prepared<poly<T, M, S>>;
+
+#endif // POLY_PREPARED_H
@@ -0,0 +1,185 @@
+#ifndef POLY_RECURRENCE_H
+#define POLY_RECURRENCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+
+#include "poly.h"
+
+// N-ty wyraz liniowej rekurencji rzędu D
+//     a_n = c[0] a_{n-1} + c[1] a_{n-2} + ... + c[D-1] a_{n-D}
+// algorytmem Fiduccii: a_n = sum r_i a_i, gdzie r = x^n mod P, a
+// P(x) = x^D - c[0] x^{D-1} - ... - c[D-1] to wielomian charakterystyczny.
+// Potęgowanie przez podnoszenie do kwadratu kosztuje O(M(D) log n) zamiast
+// O(D^3 log n) przy potęgowaniu macierzy. T musi być pierścieniem
+// (np. liczby modulo 2^64 albo własny typ modularny).
+template <typename T, size_t D>
+class linear_recurrence
+{
+    static_assert(D >= 1, "rekurencja musi mieć rząd co najmniej 1");
+
+public:
+    using residue = poly<T, D>;
+
+    constexpr linear_recurrence(const std::array<T, D> &coefficients, const std::array<T, D> &initial)
+        : init(initial)
+    {
+        // x^D = low(x) mod P
+        for (size_t i = 0; i < D; ++i)
+            low[i] = coefficients[D - 1 - i];
+
+        // odwrotność rev(P) = 1 - c[0] x - c[1] x^2 - ... modulo x^{D-1};
+        // liczona raz, więc wystarcza wzór rekurencyjny
+        if constexpr (D > 1)
+        {
+            inv_rev[0] = T(1);
+            for (size_t k = 1; k < D - 1; ++k)
+            {
+                T sum = T();
+                for (size_t i = 1; i <= k; ++i)
+                    sum += coefficients[i - 1] * inv_rev[k - i];
+                inv_rev[k] = sum;
+            }
+        }
+    }
+
+    // a_n
+    constexpr T operator()(std::uint64_t n) const
+    {
+        return combine(power(n));
+    }
+
+    // x^n mod P
+    constexpr residue power(std::uint64_t n) const
+    {
+        residue r;
+        r[0] = T(1);
+        for (int bit = std::bit_width(n); bit-- > 0;)
+        {
+            r = multiply(r, r);
+            if ((n >> bit) & 1)
+                r = shift(r);
+        }
+        return r;
+    }
+
+    // a·b mod P
+    constexpr residue multiply(const residue &a, const residue &b) const
+    {
+        return reduce(a * b);
+    }
+
+    // Wyrazy a_{ns[k]} dla wielu indeksów tej samej rekurencji. Potęgi
+    // x^{j 16^w} mod P są liczone raz, a każdy indeks kosztuje potem co
+    // najwyżej jedno mnożenie modulo P na cyfrę szesnastkową zamiast
+    // podnoszenia do kwadratu dla każdego bitu.
+    void terms(const std::uint64_t *ns, size_t count, T *out) const
+    {
+        std::uint64_t largest = 0;
+        for (size_t k = 0; k < count; ++k)
+            largest = std::max(largest, ns[k]);
+
+        size_t windows = (std::bit_width(largest) + window_bits - 1) / window_bits;
+        // table[w * digits + j] = x^{j 16^w} mod P, j = 1 .. 15
+        std::vector<residue> table(windows * digits);
+        for (size_t w = 0; w < windows; ++w)
+        {
+            residue *row = table.data() + w * digits;
+            if (w == 0)
+                row[1] = shift(row[0] = one());
+            else
+                row[1] = multiply(row[-1], row[1 - digits]);
+            for (size_t j = 2; j < digits; ++j)
+                row[j] = multiply(row[j - 1], row[1]);
+        }
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            residue r = one();
+            bool first = true;
+            for (size_t w = 0; w < windows; ++w)
+            {
+                size_t j = (ns[k] >> (w * window_bits)) & (digits - 1);
+                if (j == 0)
+                    continue;
+                const residue &step = table[w * digits + j];
+                r = first ? step : multiply(r, step);
+                first = false;
+            }
+            out[k] = combine(r);
+        }
+    }
+
+    std::vector<T> terms(const std::vector<std::uint64_t> &ns) const
+    {
+        std::vector<T> out(ns.size());
+        terms(ns.data(), ns.size(), out.data());
+        return out;
+    }
+
+private:
+    static constexpr size_t window_bits = 4;
+    static constexpr size_t digits = size_t(1) << window_bits;
+
+    std::array<T, D> init;
+    residue low;
+    poly<T, D - 1> inv_rev;
+
+    static constexpr residue one()
+    {
+        residue r;
+        r[0] = T(1);
+        return r;
+    }
+
+    // x·r mod P
+    constexpr residue shift(const residue &r) const
+    {
+        residue s;
+        T top = r[D - 1];
+        for (size_t i = D - 1; i > 0; --i)
+            s[i] = r[i - 1] + top * low[i];
+        s[0] = top * low[0];
+        return s;
+    }
+
+    // f mod P dla deg f <= 2D - 2: iloraz q z odwróconych współczynników
+    // (rev q = rev f · inv_rev mod x^{D-1}), potem f - qP = f + q·low na
+    // niższych D współczynnikach. Oba kroki to zwykłe mnożenie wielomianów.
+    template <typename F>
+    constexpr residue reduce(const F &f) const
+    {
+        residue r;
+        for (size_t i = 0; i < D; ++i)
+            r[i] = f[i];
+        if constexpr (D > 1)
+        {
+            poly<T, D - 1> high;
+            for (size_t i = 0; i < D - 1; ++i)
+                high[i] = f[2 * D - 2 - i];
+            auto q_rev = high * inv_rev;
+            poly<T, D - 1> q;
+            for (size_t i = 0; i < D - 1; ++i)
+                q[i] = q_rev[D - 2 - i];
+            auto correction = q * low;
+            for (size_t i = 0; i < D; ++i)
+                r[i] += correction[i];
+        }
+        return r;
+    }
+
+    // sum r_i a_i
+    constexpr T combine(const residue &r) const
+    {
+        T sum = T();
+        for (size_t i = 0; i < D; ++i)
+            sum += r[i] * init[i];
+        return sum;
+    }
+};
+
+#endif // POLY_RECURRENCE_H
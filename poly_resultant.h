@@ -0,0 +1,336 @@
+#ifndef POLY_RESULTANT_H
+#define POLY_RESULTANT_H
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "poly.h"
+
+// Rugownik i wyróżnik.
+//
+// Dla wielomianów jednej zmiennej rugownik liczy ciąg podrugowników
+// (subresultant PRS): kolejne pseudoreszty dzielone są dokładnie przez
+// znane czynniki, więc współczynniki rosną tylko wielomianowo, a całość
+// kosztuje O(n^2) działań na T. Dzielenia są dokładne, więc T może być
+// liczbą całkowitą albo ciałem.
+//
+// Dla poly<poly<T, M>, N> eliminujemy zmienną zewnętrzną (pierwszy
+// argument at()). Wynik jest wielomianem zmiennej wewnętrznej y o stopniu
+// ograniczonym przez deg_x p · deg_y q + deg_x q · deg_y p; liczymy go w
+// punktach y = 0, 1, ..., D (przy POLY_PARALLEL równolegle) i odtwarzamy
+// interpolacją Newtona z dokładnymi dzieleniami. Przy T całkowitym wartości
+// w tych punktach szybko rosną, więc duże przypadki wymagają szerokiego albo
+// modularnego typu współczynników.
+
+namespace detail
+{
+    template <typename T>
+    constexpr T ipow(T base, size_t e)
+    {
+        T res = T(1);
+        for (; e != 0; e >>= 1, base = base * base)
+            if (e & 1)
+                res = res * base;
+        return res;
+    }
+
+    // stopień wielomianu o współczynnikach w wektorze, -1 dla zera
+    template <typename T>
+    long vec_degree(const std::vector<T> &a)
+    {
+        long d = static_cast<long>(a.size()) - 1;
+        while (d >= 0 && a[d] == T())
+            --d;
+        return d;
+    }
+
+    // lc(b)^{deg a - deg b + 1} · a mod b, bez dzieleń
+    template <typename T>
+    std::vector<T> pseudo_remainder(std::vector<T> a, const std::vector<T> &b)
+    {
+        size_t db = b.size() - 1;
+        const T lead = b[db];
+        // dokładnie deg a - deg b + 1 kroków, także gdy wiodący współczynnik jest zerem
+        while (a.size() > db)
+        {
+            size_t top = a.size() - 1;
+            T c = a[top];
+            for (size_t j = 0; j < top; ++j)
+                a[j] = a[j] * lead;
+            for (size_t j = 0; j < db; ++j)
+                a[top - db + j] = a[top - db + j] - c * b[j];
+            a.pop_back();
+        }
+        return a;
+    }
+
+    // Res(a, b) dla niezerowych a, b bez zer na końcu (Cohen, alg. 3.3.7,
+    // bez wyciągania zawartości)
+    template <typename T>
+    T subresultant(std::vector<T> a, std::vector<T> b)
+    {
+        size_t da = a.size() - 1, db = b.size() - 1;
+        if (da == 0)
+            return ipow(a[0], db);
+        if (db == 0)
+            return ipow(b[0], da);
+
+        bool negate = false;
+        if (da < db)
+        {
+            std::swap(a, b);
+            std::swap(da, db);
+            negate = (da & db & 1) != 0;
+        }
+
+        T g = T(1), h = T(1);
+        while (true)
+        {
+            size_t delta = da - db;
+            if (da & db & 1)
+                negate = !negate;
+            std::vector<T> r = pseudo_remainder(std::move(a), b);
+            long dr = vec_degree(r);
+            if (dr < 0)
+                return T();
+            r.resize(static_cast<size_t>(dr) + 1);
+
+            T divisor = g * ipow(h, delta);
+            for (T &c : r)
+                c = c / divisor;
+            a = std::move(b);
+            b = std::move(r);
+            da = db;
+            db = static_cast<size_t>(dr);
+            g = a[da];
+            // h <- h^{1 - delta} g^delta
+            if (delta != 0)
+                h = ipow(g, delta) / ipow(h, delta - 1);
+
+            if (db == 0)
+            {
+                h = ipow(b[0], da) / ipow(h, da - 1);
+                return negate ? -h : h;
+            }
+        }
+    }
+
+    // Res_{m, n}(a, b) względem formalnych stopni m i n: współczynniki
+    // wiodące mogą być zerami (np. po podstawieniu wartości za drugą zmienną)
+    template <typename T>
+    T formal_resultant(std::vector<T> a, size_t m, std::vector<T> b, size_t n)
+    {
+        if (m == 0 && n == 0)
+            return T(1);
+        long da = vec_degree(a), db = vec_degree(b);
+        if (da < 0 || db < 0)
+            return T();
+        T lead_a = static_cast<size_t>(da) == m ? a[m] : T();
+        T lead_b = static_cast<size_t>(db) == n ? b[n] : T();
+        a.resize(static_cast<size_t>(da) + 1);
+        b.resize(static_cast<size_t>(db) + 1);
+        if (static_cast<size_t>(da) == m)
+            return ipow(lead_a, n - static_cast<size_t>(db)) * subresultant(std::move(a), std::move(b));
+        if (static_cast<size_t>(db) == n)
+        {
+            // Res_{m,n}(a, b) = (-1)^{mn} Res_{n,m}(b, a)
+            T res = ipow(lead_b, m - static_cast<size_t>(da)) * subresultant(std::move(a), std::move(b));
+            return ((m * n + static_cast<size_t>(da) * n) & 1) ? -res : res;
+        }
+        return T();
+    }
+
+    // współczynniki zewnętrzne dwóch zmiennych: c[i][j] przy x^i y^j
+    template <typename R, typename T, size_t M, typename SI, size_t N, typename S>
+    std::vector<std::vector<R>> to_table(const poly<poly<T, M, SI>, N, S> &p)
+    {
+        std::vector<std::vector<R>> c(N, std::vector<R>(M));
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < M; ++j)
+                c[i][j] = static_cast<R>(p[i][j]);
+        return c;
+    }
+
+    // stopień w x: ostatni niezerowy współczynnik zewnętrzny, -1 dla zera
+    template <typename R>
+    long outer_degree(const std::vector<std::vector<R>> &c)
+    {
+        for (long i = static_cast<long>(c.size()) - 1; i >= 0; --i)
+            if (vec_degree(c[i]) >= 0)
+                return i;
+        return -1;
+    }
+
+    // p(x, y0) jako wielomian x
+    template <typename R>
+    std::vector<R> specialize(const std::vector<std::vector<R>> &c, size_t degree, const R &y0)
+    {
+        std::vector<R> res(degree + 1);
+        for (size_t i = 0; i <= degree; ++i)
+        {
+            R acc = R();
+            for (size_t j = c[i].size(); j-- > 0;)
+                acc = acc * y0 + c[i][j];
+            res[i] = acc;
+        }
+        return res;
+    }
+
+    // wielomian stopnia <= D o wartościach values[k] w punktach k = 0 .. D;
+    // ilorazy różnicowe wielomianu całkowitego w punktach całkowitych są
+    // całkowite, więc dzielenia są dokładne
+    template <typename R>
+    std::vector<R> interpolate_integer_nodes(std::vector<R> values)
+    {
+        size_t D = values.size() - 1;
+        for (size_t level = 1; level <= D; ++level)
+            for (size_t k = D; k >= level; --k)
+                values[k] = (values[k] - values[k - 1]) / R(static_cast<long long>(level));
+        // postać Newtona -> jednomiany: res = res · (y - k) + c_k
+        std::vector<R> res(D + 1);
+        res[0] = values[D];
+        size_t len = 1;
+        for (size_t k = D; k-- > 0;)
+        {
+            R node = R(static_cast<long long>(k));
+            for (size_t i = len; i > 0; --i)
+                res[i] = res[i - 1] - node * res[i];
+            res[0] = values[k] - node * res[0];
+            ++len;
+        }
+        return res;
+    }
+
+    // Res_x(p, q) jako wielomian y stopnia <= D
+    template <typename R>
+    std::vector<R> bivariate_resultant(const std::vector<std::vector<R>> &p, const std::vector<std::vector<R>> &q, size_t D)
+    {
+        long m = outer_degree(p), n = outer_degree(q);
+        if (m < 0 || n < 0)
+            return std::vector<R>(D + 1);
+
+        std::vector<R> values(D + 1);
+        auto evaluate = [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k)
+            {
+                R y0 = R(static_cast<long long>(k));
+                values[k] = formal_resultant(specialize(p, m, y0), m, specialize(q, n, y0), n);
+            }
+        };
+#ifdef POLY_PARALLEL
+        poly_thread_pool &pool = poly_thread_pool::instance();
+        if (pool.size() > 1 && D + 1 >= 2 * pool.size())
+        {
+            // kilka kawałków na wątek, żeby podkradanie wyrównało obciążenie
+            size_t chunk = (D + 1 + 4 * pool.size() - 1) / (4 * pool.size());
+            poly_thread_pool::task_group group(pool);
+            for (size_t lo = 0; lo < D + 1; lo += chunk)
+                group.spawn([&evaluate, lo, hi = std::min(D + 1, lo + chunk)] { evaluate(lo, hi); });
+            group.wait();
+        }
+        else
+#endif
+            evaluate(0, D + 1);
+
+        return interpolate_integer_nodes(std::move(values));
+    }
+
+    // a / b dla wielomianów, o których wiadomo, że b dzieli a
+    template <typename R>
+    std::vector<R> exact_quotient(std::vector<R> a, const std::vector<R> &b)
+    {
+        long da = vec_degree(a), db = vec_degree(b);
+        if (da < db)
+            return std::vector<R>(a.size());
+        std::vector<R> q(a.size());
+        for (long k = da - db; k >= 0; --k)
+        {
+            R c = a[k + db] / b[db];
+            q[k] = c;
+            for (long j = 0; j <= db; ++j)
+                a[k + j] = a[k + j] - c * b[j];
+        }
+        return q;
+    }
+}
+
+// Res(p, q) względem faktycznych stopni p i q; 0, gdy któryś jest zerem
+template <typename T, size_t N, typename S, typename U, size_t M, typename SU>
+    requires(!detail::is_poly_v<T> && !detail::is_poly_v<U> && N > 0 && M > 0)
+auto resultant(const poly<T, N, S> &p, const poly<U, M, SU> &q)
+{
+    using R = std::common_type_t<T, U>;
+    std::vector<R> a(p.data(), p.data() + N), b(q.data(), q.data() + M);
+    long da = detail::vec_degree(a), db = detail::vec_degree(b);
+    if (da < 0 || db < 0)
+        return R();
+    return detail::formal_resultant(std::move(a), static_cast<size_t>(da), std::move(b), static_cast<size_t>(db));
+}
+
+// (-1)^{n(n-1)/2} Res(p, p') / lc(p) dla n = deg p; 1 dla stałych
+template <typename T, size_t N, typename S>
+    requires(!detail::is_poly_v<T> && N > 0)
+T discriminant(const poly<T, N, S> &p)
+{
+    std::vector<T> a(p.data(), p.data() + N);
+    long n = detail::vec_degree(a);
+    if (n <= 0)
+        return T(1);
+    a.resize(static_cast<size_t>(n) + 1);
+    std::vector<T> da(static_cast<size_t>(n));
+    for (long i = 1; i <= n; ++i)
+        da[i - 1] = a[i] * T(i);
+    T lead = a[n];
+    T res = detail::subresultant(std::move(a), std::move(da)) / lead;
+    return ((n * (n - 1) / 2) & 1) ? -res : res;
+}
+
+// Res_x(p, q) dla p(x, y) = sum p[i](y) x^i; wynik jest wielomianem y
+template <typename T, size_t M1, typename S1, size_t N1, typename S, typename U, size_t M2, typename S2, size_t N2,
+          typename SU>
+    requires(!detail::is_poly_v<T> && !detail::is_poly_v<U> && N1 > 0 && N2 > 0 && M1 > 0 && M2 > 0)
+auto resultant(const poly<poly<T, M1, S1>, N1, S> &p, const poly<poly<U, M2, S2>, N2, SU> &q)
+{
+    using R = std::common_type_t<T, U>;
+    constexpr size_t D = (N1 - 1) * (M2 - 1) + (N2 - 1) * (M1 - 1);
+    std::vector<R> c = detail::bivariate_resultant(detail::to_table<R>(p), detail::to_table<R>(q), D);
+    poly<R, D + 1> res;
+    for (size_t i = 0; i <= D; ++i)
+        res[i] = c[i];
+    return res;
+}
+
+// wyróżnik względem x jako wielomian y
+template <typename T, size_t M, typename SI, size_t N, typename S>
+    requires(!detail::is_poly_v<T> && N > 1 && M > 0)
+auto discriminant(const poly<poly<T, M, SI>, N, S> &p)
+{
+    // Res(p, p'_x) ma stopień w y <= (2N - 3)(M - 1), a po podzieleniu
+    // przez lc_x(p) o M - 1 mniej
+    constexpr size_t D = (2 * N - 3) * (M - 1);
+    constexpr size_t K = (2 * N - 4) * (M - 1) + 1;
+    auto c = detail::to_table<T>(p);
+    poly<T, K> res;
+    long n = detail::outer_degree(c);
+    if (n <= 0)
+    {
+        res[0] = T(1);
+        return res;
+    }
+    std::vector<std::vector<T>> dc(static_cast<size_t>(n), std::vector<T>(M));
+    for (long i = 1; i <= n; ++i)
+        for (size_t j = 0; j < M; ++j)
+            dc[i - 1][j] = c[i][j] * T(i);
+
+    std::vector<T> r = detail::bivariate_resultant(c, dc, D);
+    std::vector<T> q = detail::exact_quotient(std::move(r), c[n]);
+    bool negate = ((n * (n - 1) / 2) & 1) != 0;
+    for (size_t i = 0; i < K; ++i)
+        res[i] = negate ? -q[i] : q[i];
+    return res;
+}
+
+#endif // POLY_RESULTANT_H
@@ -0,0 +1,363 @@
+#ifndef POLY_STORAGE_H
+#define POLY_STORAGE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Polityki przechowywania współczynników wielomianu.
+// Każda polityka udostępnia szablon buffer<T, N> z interfejsem:
+//  - konstruktor bezargumentowy inicjalizujący wartościowo N elementów,
+//  - kopiowanie i przenoszenie,
+//  - operator[] oraz data() dające ciągły blok N elementów,
+//  - revive(), które przywraca bufor po przeniesieniu (dla inline nic nie robi).
+namespace poly_storage
+{
+    // Współczynniki osadzone w obiekcie (std::array) - zachowanie domyślne.
+    struct inline_buffer
+    {
+        template <typename T, size_t N>
+        struct buffer
+        {
+            std::array<T, N> a;
+
+            constexpr T &operator[](size_t i) { return a[i]; }
+            constexpr const T &operator[](size_t i) const { return a[i]; }
+            constexpr T *data() { return a.data(); }
+            constexpr const T *data() const { return a.data(); }
+            constexpr void revive() {}
+        };
+    };
+
+    // Współczynniki w obiekcie wyrównanym do 64 bajtów (linia pamięci
+    // podręcznej), a dla typów liczbowych z liczbą elementów dopełnioną zerami
+    // do wielokrotności szerokości wektora SIMD (simd_bytes). Wielomian widzi
+    // tylko N pierwszych elementów i nigdy nie zapisuje dopełnienia, więc
+    // zostaje ono zerowe; jądra wektorowe mogą przetwarzać cały blok
+    // padded_size elementów bez pętli resztowej. Wiersze poly<poly<float, 7,
+    // aligned>, N, aligned> zajmują wtedy po jednej linii.
+    struct aligned
+    {
+        static constexpr size_t alignment = 64;
+        static constexpr size_t simd_bytes = 64;
+
+        template <typename T, size_t N>
+        static constexpr size_t padded_size =
+            std::is_arithmetic_v<T> ? (N * sizeof(T) + simd_bytes - 1) / simd_bytes * simd_bytes / sizeof(T) : N;
+
+        template <typename T, size_t N>
+        struct buffer
+        {
+            alignas(alignment) std::array<T, padded_size<T, N>> a;
+
+            constexpr T &operator[](size_t i) { return a[i]; }
+            constexpr const T &operator[](size_t i) const { return a[i]; }
+            constexpr T *data() { return a.data(); }
+            constexpr const T *data() const { return a.data(); }
+            constexpr void revive() {}
+        };
+    };
+
+    // Współczynniki na stercie. Przenoszenie jest O(1): przeniesiony obiekt
+    // nie ma bufora i wolno go jedynie zniszczyć albo coś do niego przypisać.
+    struct heap
+    {
+        template <typename T, size_t N>
+        class buffer
+        {
+        public:
+            constexpr buffer() : p(new T[N]()) {}
+
+            constexpr buffer(const buffer &other) : p(new T[N])
+            {
+                std::copy(other.p, other.p + N, p);
+            }
+
+            constexpr buffer(buffer &&other) noexcept : p(std::exchange(other.p, nullptr)) {}
+
+            constexpr buffer &operator=(const buffer &other)
+            {
+                if (this != &other)
+                {
+                    revive();
+                    std::copy(other.p, other.p + N, p);
+                }
+                return *this;
+            }
+
+            constexpr buffer &operator=(buffer &&other) noexcept
+            {
+                std::swap(p, other.p);
+                return *this;
+            }
+
+            constexpr ~buffer() { delete[] p; }
+
+            constexpr T &operator[](size_t i) { return p[i]; }
+            constexpr const T &operator[](size_t i) const { return p[i]; }
+            constexpr T *data() { return p; }
+            constexpr const T *data() const { return p; }
+
+            constexpr void revive()
+            {
+                if (p == nullptr)
+                    p = new T[N]();
+            }
+
+        private:
+            T *p;
+        };
+    };
+}
+
+// ARENA
+// Bufor przydziałów zwalnianych hurtowo. Wielomiany z polityką
+// poly_storage::arena biorą pamięć z areny aktywnej w danym wątku
+// (poly_arena::scope), a reset() albo zniszczenie areny oddaje całą pamięć
+// naraz. Wielomiany nie mogą przeżyć areny, z której pochodzą.
+class poly_arena
+{
+public:
+    explicit poly_arena(size_t block_size = 1 << 20) : block_size(block_size) {}
+
+    poly_arena(const poly_arena &) = delete;
+    poly_arena &operator=(const poly_arena &) = delete;
+
+    void *allocate(size_t bytes, size_t align)
+    {
+        if (blocks.empty() || aligned_offset(align) + bytes > blocks[current].size)
+            next_block(bytes + align);
+        size_t start = aligned_offset(align);
+        used = start + bytes;
+        return blocks[current].mem.get() + start;
+    }
+
+    // Zwalnia wszystkie przydziały; bloki zostają do ponownego użycia.
+    void reset()
+    {
+        current = 0;
+        used = 0;
+    }
+
+    // Arena aktywna w bieżącym wątku albo nullptr.
+    static poly_arena *active() { return active_ref(); }
+
+    // Ustawia arenę jako aktywną do końca zasięgu.
+    class scope
+    {
+    public:
+        explicit scope(poly_arena &arena) : previous(active_ref()) { active_ref() = &arena; }
+        ~scope() { active_ref() = previous; }
+        scope(const scope &) = delete;
+        scope &operator=(const scope &) = delete;
+
+    private:
+        poly_arena *previous;
+    };
+
+private:
+    struct block
+    {
+        std::unique_ptr<std::byte[]> mem;
+        size_t size;
+    };
+
+    std::vector<block> blocks;
+    size_t current = 0;
+    size_t used = 0;
+    size_t block_size;
+
+    size_t aligned_offset(size_t align) const
+    {
+        size_t base = reinterpret_cast<size_t>(blocks[current].mem.get());
+        return ((base + used + align - 1) & ~(align - 1)) - base;
+    }
+
+    void next_block(size_t min_bytes)
+    {
+        if (!blocks.empty())
+            ++current;
+        while (current < blocks.size() && blocks[current].size < min_bytes)
+            ++current;
+        if (current >= blocks.size())
+        {
+            size_t size = std::max(block_size, min_bytes);
+            blocks.push_back({std::make_unique<std::byte[]>(size), size});
+            current = blocks.size() - 1;
+        }
+        used = 0;
+    }
+
+    static poly_arena *&active_ref()
+    {
+        thread_local poly_arena *arena = nullptr;
+        return arena;
+    }
+};
+
+namespace detail
+{
+    // Pula bloków jednego rozmiaru, osobna dla każdego wątku.
+    template <size_t Bytes, size_t Align>
+    class block_pool
+    {
+    public:
+        static void *allocate()
+        {
+            node *&head = free_list();
+            if (head != nullptr)
+                return std::exchange(head, head->next);
+            return ::operator new(std::max(Bytes, sizeof(node)), std::align_val_t{Align});
+        }
+
+        static void deallocate(void *p)
+        {
+            node *n = static_cast<node *>(p);
+            n->next = free_list();
+            free_list() = n;
+        }
+
+    private:
+        struct node
+        {
+            node *next;
+        };
+
+        struct list
+        {
+            node *head = nullptr;
+            ~list()
+            {
+                while (head != nullptr)
+                    ::operator delete(std::exchange(head, head->next), std::align_val_t{Align});
+            }
+        };
+
+        static node *&free_list()
+        {
+            thread_local list l;
+            return l.head;
+        }
+    };
+
+    // Wspólna część buforów z pamięcią spoza obiektu: elementy konstruowane
+    // są w miejscu, a zwolnieniem pamięci zajmuje się Alloc.
+    template <typename T, size_t N, typename Alloc>
+    class external_buffer
+    {
+    public:
+        external_buffer() : p(create()) { std::uninitialized_value_construct_n(p, N); }
+
+        external_buffer(const external_buffer &other) : p(create())
+        {
+            std::uninitialized_copy_n(other.p, N, p);
+        }
+
+        external_buffer(external_buffer &&other) noexcept
+            : owner(std::exchange(other.owner, nullptr)), p(std::exchange(other.p, nullptr)) {}
+
+        external_buffer &operator=(const external_buffer &other)
+        {
+            if (this != &other)
+            {
+                revive();
+                std::copy_n(other.p, N, p);
+            }
+            return *this;
+        }
+
+        external_buffer &operator=(external_buffer &&other) noexcept
+        {
+            std::swap(p, other.p);
+            std::swap(owner, other.owner);
+            return *this;
+        }
+
+        ~external_buffer() { release(); }
+
+        T &operator[](size_t i) { return p[i]; }
+        const T &operator[](size_t i) const { return p[i]; }
+        T *data() { return p; }
+        const T *data() const { return p; }
+
+        void revive()
+        {
+            if (p == nullptr)
+            {
+                p = create();
+                std::uninitialized_value_construct_n(p, N);
+            }
+        }
+
+    private:
+        // owner musi być zainicjalizowany przed p, bo ustawia go create()
+        void *owner = nullptr;
+        T *p;
+
+        T *create() { return static_cast<T *>(Alloc::allocate(sizeof(T) * N, alignof(T), owner)); }
+
+        void release()
+        {
+            if (p != nullptr)
+            {
+                std::destroy_n(p, N);
+                Alloc::deallocate(p, sizeof(T) * N, alignof(T), owner);
+            }
+        }
+    };
+}
+
+namespace poly_storage
+{
+    // Współczynniki w aktywnej arenie wątku. Bez aktywnej areny bufor trafia
+    // na stertę i jest zwalniany normalnie.
+    struct arena
+    {
+        static void *allocate(size_t bytes, size_t align, void *&owner)
+        {
+            poly_arena *a = poly_arena::active();
+            owner = a;
+            if (a != nullptr)
+                return a->allocate(bytes, align);
+            return ::operator new(bytes, std::align_val_t{align});
+        }
+
+        static void deallocate(void *p, size_t, size_t align, void *owner)
+        {
+            if (owner == nullptr)
+                ::operator delete(p, std::align_val_t{align});
+        }
+
+        template <typename T, size_t N>
+        using buffer = detail::external_buffer<T, N, arena>;
+    };
+
+    // Współczynniki w puli bloków rozmiaru sizeof(T) * N, wspólnej dla
+    // wszystkich wielomianów tego typu w wątku.
+    struct pool
+    {
+        template <typename T, size_t N>
+        struct allocator
+        {
+            static void *allocate(size_t, size_t, void *&)
+            {
+                return detail::block_pool<sizeof(T) * N, std::max(alignof(T), alignof(void *))>::allocate();
+            }
+
+            static void deallocate(void *p, size_t, size_t, void *)
+            {
+                detail::block_pool<sizeof(T) * N, std::max(alignof(T), alignof(void *))>::deallocate(p);
+            }
+        };
+
+        template <typename T, size_t N>
+        using buffer = detail::external_buffer<T, N, allocator<T, N>>;
+    };
+}
+
+#endif // POLY_STORAGE_H
@@ -0,0 +1,161 @@
+#ifndef POLY_TRACE_H
+#define POLY_TRACE_H
+
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "poly.h"
+
+// Śledzenie cyklu życia współczynników: poly_trace::traced<T> zlicza
+// konstrukcje, kopiowania, przeniesienia, przypisania i destrukcje (tak jak
+// Integer<T> w rational.cc, ale zamiast wypisywać - liczy). Pozwala
+// sprawdzić, ile kopii i przeniesień współczynników wykonuje dana operacja
+// wielomianów. Liczniki są osobne dla każdego wątku.
+namespace poly_trace
+{
+    struct counts
+    {
+        size_t default_constructions = 0;
+        // z wartości typu współczynnika albo wyniku działania
+        size_t value_constructions = 0;
+        size_t copies = 0;
+        size_t moves = 0;
+        size_t copy_assignments = 0;
+        size_t move_assignments = 0;
+        size_t destructions = 0;
+
+        constexpr bool operator==(const counts &) const = default;
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const counts &c)
+    {
+        return os << "default=" << c.default_constructions << " value=" << c.value_constructions
+                  << " copy=" << c.copies << " move=" << c.moves << " copy_assign=" << c.copy_assignments
+                  << " move_assign=" << c.move_assignments << " destroy=" << c.destructions;
+    }
+
+    namespace internal
+    {
+        inline counts &thread_counts()
+        {
+            thread_local counts c;
+            return c;
+        }
+
+        inline void tick(size_t counts::*field)
+        {
+            ++(thread_counts().*field);
+        }
+    }
+
+    // Zeruje liczniki bieżącego wątku.
+    inline void reset() { internal::thread_counts() = counts{}; }
+
+    // Liczniki bieżącego wątku od ostatniego reset().
+    inline counts snapshot() { return internal::thread_counts(); }
+
+    // Zdarzenia wykonane przez f() w bieżącym wątku.
+    template <typename F>
+    counts measure(F &&f)
+    {
+        counts saved = snapshot();
+        reset();
+        std::forward<F>(f)();
+        counts result = snapshot();
+        internal::thread_counts() = saved;
+        return result;
+    }
+
+    // Współczynnik śledzący. Nie działa w czasie kompilacji.
+    template <typename T>
+    class traced
+    {
+    public:
+        traced() noexcept(std::is_nothrow_default_constructible_v<T>) : value()
+        {
+            internal::tick(&counts::default_constructions);
+        }
+
+        template <typename U>
+            requires(std::is_convertible_v<U, T>)
+        traced(const U &u) : value(static_cast<T>(u))
+        {
+            internal::tick(&counts::value_constructions);
+        }
+
+        traced(const traced &other) : value(other.value) { internal::tick(&counts::copies); }
+        traced(traced &&other) noexcept : value(std::move(other.value)) { internal::tick(&counts::moves); }
+
+        traced &operator=(const traced &other)
+        {
+            internal::tick(&counts::copy_assignments);
+            value = other.value;
+            return *this;
+        }
+
+        traced &operator=(traced &&other) noexcept
+        {
+            internal::tick(&counts::move_assignments);
+            value = std::move(other.value);
+            return *this;
+        }
+
+        ~traced() { internal::tick(&counts::destructions); }
+
+        const T &get() const { return value; }
+
+        traced &operator+=(const traced &other)
+        {
+            value += other.value;
+            return *this;
+        }
+
+        traced &operator-=(const traced &other)
+        {
+            value -= other.value;
+            return *this;
+        }
+
+        traced &operator*=(const traced &other)
+        {
+            value *= other.value;
+            return *this;
+        }
+
+        friend traced operator+(const traced &a, const traced &b) { return traced(a.value + b.value); }
+        friend traced operator-(const traced &a, const traced &b) { return traced(a.value - b.value); }
+        friend traced operator*(const traced &a, const traced &b) { return traced(a.value * b.value); }
+        traced operator-() const { return traced(-value); }
+
+        friend bool operator==(const traced &a, const traced &b) { return a.value == b.value; }
+
+        friend std::ostream &operator<<(std::ostream &os, const traced &t) { return os << t.value; }
+
+    private:
+        T value;
+    };
+}
+
+template <typename T, typename U>
+struct std::common_type<poly_trace::traced<T>, poly_trace::traced<U>>
+{
+    using type = poly_trace::traced<std::common_type_t<T, U>>;
+};
+
+template <typename T, typename U>
+    requires(std::is_arithmetic_v<U>)
+struct std::common_type<poly_trace::traced<T>, U>
+{
+    using type = poly_trace::traced<std::common_type_t<T, U>>;
+};
+
+template <typename T, typename U>
+    requires(std::is_arithmetic_v<U>)
+struct std::common_type<U, poly_trace::traced<T>>
+{
+    using type = poly_trace::traced<std::common_type_t<T, U>>;
+};
+
+#endif // POLY_TRACE_H
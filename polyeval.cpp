@@ -0,0 +1,568 @@
+// polyeval: strumieniowe obliczanie wartości zbioru wielomianów w punktach
+// czytanych z plików albo ze standardowego wejścia.
+//
+//     polyeval -p WIELOMIANY [-o WYJŚCIE] [-b PARTIA] [-q KOLEJKA] [--stats] [PLIK...]
+//     polyeval --tune
+//
+// Plik wielomianów zawiera po jednym wielomianie w wierszu (współczynniki od
+// wyrazu wolnego, puste wiersze i wiersze od '#' są pomijane). Punkty to
+// liczby rozdzielone białymi znakami. Dla każdego punktu wypisywany jest
+// wiersz wartości kolejnych wielomianów.
+//
+// Czytanie, obliczanie i zapis działają w osobnych wątkach połączonych
+// ograniczonymi kolejkami bez blokad. Partie krążą w stałej puli, więc
+// zużycie pamięci nie zależy od rozmiaru wejścia.
+//
+// --tune mierzy progi algorytmów na tej maszynie i zapisuje je w pliku
+// poly_autotune::default_cache_path(); zwykłe uruchomienia wczytują ten
+// plik, jeśli istnieje.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "poly.h"
+#include "poly_autotune.h"
+#include "poly_bank.h"
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Kolejka jeden producent - jeden konsument na buforze cyklicznym.
+    template <typename T>
+    class spsc_queue
+    {
+    public:
+        explicit spsc_queue(size_t capacity) : slots(capacity + 1) {}
+
+        bool try_push(T value)
+        {
+            size_t tail = write.load(std::memory_order_relaxed);
+            size_t next = tail + 1 == slots.size() ? 0 : tail + 1;
+            if (next == read.load(std::memory_order_acquire))
+                return false;
+            slots[tail] = value;
+            write.store(next, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T &value)
+        {
+            size_t head = read.load(std::memory_order_relaxed);
+            if (head == write.load(std::memory_order_acquire))
+                return false;
+            value = slots[head];
+            read.store(head + 1 == slots.size() ? 0 : head + 1, std::memory_order_release);
+            return true;
+        }
+
+        void push(T value)
+        {
+            while (!try_push(value))
+                std::this_thread::yield();
+        }
+
+        T pop()
+        {
+            T value;
+            while (!try_pop(value))
+                std::this_thread::yield();
+            return value;
+        }
+
+    private:
+        std::vector<T> slots;
+        alignas(64) std::atomic<size_t> read{0};
+        alignas(64) std::atomic<size_t> write{0};
+    };
+
+    struct batch
+    {
+        std::vector<double> points;
+        std::vector<double> values;
+        size_t count = 0;
+        // ostatnia partia strumienia (może być pusta)
+        bool last = false;
+        clock_type::time_point parsed;
+    };
+
+    // Histogram opóźnień w przedziałach potęg dwójki mikrosekund.
+    class latency_histogram
+    {
+    public:
+        void add(clock_type::duration d)
+        {
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+            size_t bucket = 0;
+            while (bucket + 1 < buckets && (std::int64_t(1) << bucket) <= us)
+                ++bucket;
+            ++counts[bucket];
+            ++total;
+            worst = std::max(worst, d);
+        }
+
+        // górne oszacowanie kwantyla q w mikrosekundach
+        std::int64_t quantile(double q) const
+        {
+            size_t seen = 0;
+            for (size_t b = 0; b < buckets; ++b)
+            {
+                seen += counts[b];
+                if (seen > 0 && double(seen) >= q * double(total))
+                    return std::min(std::int64_t(1) << b, max_us());
+            }
+            return 0;
+        }
+
+        std::int64_t max_us() const
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(worst).count();
+        }
+
+    private:
+        static constexpr size_t buckets = 40;
+        size_t counts[buckets] = {};
+        size_t total = 0;
+        clock_type::duration worst{};
+    };
+
+    struct options
+    {
+        std::string polys_path;
+        std::string output_path;
+        std::vector<std::string> inputs;
+        size_t batch_size = 4096;
+        size_t queue_depth = 4;
+        bool stats = false;
+        bool tune = false;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::fputs("usage: polyeval -p POLYS [-o OUTPUT] [-b BATCH] [-q DEPTH] [--stats] [INPUT...]\n"
+                   "       polyeval --tune\n",
+                   stderr);
+        std::exit(2);
+    }
+
+    options parse_options(int argc, char **argv)
+    {
+        options opt;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&] {
+                if (i + 1 >= argc)
+                    usage();
+                return std::string(argv[++i]);
+            };
+            if (arg == "-p")
+                opt.polys_path = value();
+            else if (arg == "-o")
+                opt.output_path = value();
+            else if (arg == "-b")
+                opt.batch_size = std::strtoul(value().c_str(), nullptr, 10);
+            else if (arg == "-q")
+                opt.queue_depth = std::strtoul(value().c_str(), nullptr, 10);
+            else if (arg == "--stats")
+                opt.stats = true;
+            else if (arg == "--tune")
+                opt.tune = true;
+            else if (arg == "-h" || arg == "--help")
+                usage();
+            else
+                opt.inputs.push_back(arg);
+        }
+        if (opt.tune)
+            return opt;
+        if (opt.polys_path.empty() || opt.batch_size == 0 || opt.queue_depth == 0)
+            usage();
+        if (opt.inputs.empty())
+            opt.inputs.push_back("-");
+        return opt;
+    }
+
+    // wczytuje wielomiany z pliku tekstowego
+    std::vector<std::vector<double>> read_polys(const std::string &path)
+    {
+        std::FILE *f = std::fopen(path.c_str(), "r");
+        if (f == nullptr)
+            throw std::runtime_error("cannot open " + path);
+        std::vector<std::vector<double>> polys;
+        char *line = nullptr;
+        size_t capacity = 0;
+        size_t number = 0;
+        while (getline(&line, &capacity, f) >= 0)
+        {
+            ++number;
+            const char *p = line;
+            while (*p == ' ' || *p == '\t')
+                ++p;
+            if (*p == '#' || *p == '\n' || *p == '\0')
+                continue;
+            std::vector<double> coeffs;
+            char *end;
+            for (double v = std::strtod(p, &end); end != p; v = std::strtod(p, &end))
+            {
+                coeffs.push_back(v);
+                p = end;
+            }
+            while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+                ++p;
+            if (*p != '\0')
+            {
+                std::free(line);
+                std::fclose(f);
+                throw std::runtime_error(path + ":" + std::to_string(number) + ": invalid coefficient");
+            }
+            polys.push_back(std::move(coeffs));
+        }
+        std::free(line);
+        std::fclose(f);
+        if (polys.empty())
+            throw std::runtime_error(path + ": no polynomials");
+        return polys;
+    }
+
+    // Czyta liczby z kolejnych plików blokami stałego rozmiaru; liczba
+    // przecięta granicą bloku jest przenoszona na początek następnego.
+    class point_reader
+    {
+    public:
+        explicit point_reader(const std::vector<std::string> &paths) : paths(paths), buffer(chunk + 1) {}
+
+        ~point_reader()
+        {
+            close();
+        }
+
+        // zapisuje do out co najwyżej max liczb; mniej tylko na końcu danych
+        size_t read(double *out, size_t max)
+        {
+            size_t n = 0;
+            while (n < max)
+            {
+                skip_spaces();
+                if (pos == len)
+                {
+                    if (!refill())
+                        break;
+                    continue;
+                }
+                // liczba może ciągnąć się do końca bloku, więc najpierw dociągamy resztę
+                if (std::find_if(buffer.data() + pos, buffer.data() + len, is_space) == buffer.data() + len && !eof)
+                {
+                    if (!refill())
+                        break;
+                    continue;
+                }
+                buffer[len] = '\0';
+                char *end;
+                out[n] = std::strtod(buffer.data() + pos, &end);
+                if (end == buffer.data() + pos || (end != buffer.data() + len && !is_space(*end)))
+                    throw std::runtime_error(current + ": invalid number at byte " +
+                                             std::to_string(consumed + pos));
+                pos = static_cast<size_t>(end - buffer.data());
+                ++n;
+            }
+            return n;
+        }
+
+        std::uint64_t bytes() const { return total_bytes; }
+
+    private:
+        static constexpr size_t chunk = size_t(1) << 20;
+
+        std::vector<std::string> paths;
+        size_t next_path = 0;
+        std::string current;
+        std::FILE *file = nullptr;
+        bool eof = true;
+        std::vector<char> buffer;
+        size_t pos = 0, len = 0;
+        // bajty bieżącego pliku sprzed początku bufora
+        std::uint64_t consumed = 0;
+        std::uint64_t total_bytes = 0;
+
+        static bool is_space(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        void skip_spaces()
+        {
+            while (pos < len && is_space(buffer[pos]))
+                ++pos;
+        }
+
+        void close()
+        {
+            if (file != nullptr && file != stdin)
+                std::fclose(file);
+            file = nullptr;
+        }
+
+        // Dosuwa nieprzeczytaną resztę na początek bufora i doczytuje dane,
+        // w razie potrzeby z następnego pliku. Fałsz, gdy danych już nie ma.
+        bool refill()
+        {
+            if (eof)
+            {
+                if (pos < len)
+                    return false;
+                close();
+                if (next_path == paths.size())
+                    return false;
+                current = paths[next_path++];
+                file = current == "-" ? stdin : std::fopen(current.c_str(), "rb");
+                if (file == nullptr)
+                    throw std::runtime_error("cannot open " + current);
+                eof = false;
+                pos = len = 0;
+                consumed = 0;
+            }
+            size_t rest = len - pos;
+            if (rest == chunk)
+                throw std::runtime_error(current + ": token too long");
+            std::memmove(buffer.data(), buffer.data() + pos, rest);
+            consumed += pos;
+            pos = 0;
+            size_t got = std::fread(buffer.data() + rest, 1, chunk - rest, file);
+            if (got < chunk - rest)
+            {
+                if (std::ferror(file))
+                    throw std::runtime_error("read error on " + current);
+                eof = true;
+            }
+            len = rest + got;
+            total_bytes += got;
+            return true;
+        }
+    };
+
+    // Obliczanie partii: dla wielu wielomianów jądro poly_bank (jeden punkt,
+    // wszystkie wielomiany naraz), dla kilku zwykłe at().
+    template <size_t N>
+    class evaluator
+    {
+    public:
+        explicit evaluator(const std::vector<std::vector<double>> &coeffs)
+        {
+            for (const auto &c : coeffs)
+            {
+                poly<double, N> p;
+                for (size_t i = 0; i < c.size(); ++i)
+                    p[i] = c[i];
+                polys.push_back(p);
+            }
+            if (polys.size() >= bank_threshold)
+                bank = poly_bank<double, N>(polys);
+        }
+
+        size_t size() const { return polys.size(); }
+
+        void run(batch &b) const
+        {
+            size_t k = polys.size();
+            if (polys.size() >= bank_threshold)
+            {
+                for (size_t i = 0; i < b.count; ++i)
+                    bank.evaluate_all(b.points[i], b.values.data() + i * k);
+            }
+            else
+            {
+                for (size_t i = 0; i < b.count; ++i)
+                    for (size_t j = 0; j < k; ++j)
+                        b.values[i * k + j] = polys[j].at(b.points[i]);
+            }
+        }
+
+    private:
+        static constexpr size_t bank_threshold = 8;
+
+        std::vector<poly<double, N>> polys;
+        poly_bank<double, N> bank;
+    };
+
+    template <size_t N>
+    int run(const options &opt, const std::vector<std::vector<double>> &coeffs)
+    {
+        evaluator<N> eval(coeffs);
+        const size_t k = eval.size();
+
+        std::FILE *out = opt.output_path.empty() ? stdout : std::fopen(opt.output_path.c_str(), "wb");
+        if (out == nullptr)
+            throw std::runtime_error("cannot open " + opt.output_path + " for writing");
+
+        // stała pula partii krążąca reader -> evaluator -> writer -> reader
+        size_t pool_size = opt.queue_depth + 2;
+        std::vector<std::unique_ptr<batch>> pool;
+        spsc_queue<batch *> free_batches(pool_size), parsed(pool_size), evaluated(pool_size);
+        for (size_t i = 0; i < pool_size; ++i)
+        {
+            pool.push_back(std::make_unique<batch>());
+            pool.back()->points.resize(opt.batch_size);
+            pool.back()->values.resize(opt.batch_size * k);
+            free_batches.push(pool.back().get());
+        }
+
+        std::string error;
+        std::atomic<bool> failed{false};
+        std::uint64_t input_bytes = 0;
+        auto start = clock_type::now();
+
+        std::thread reader_thread([&] {
+            point_reader reader(opt.inputs);
+            while (true)
+            {
+                batch *b = free_batches.pop();
+                try
+                {
+                    b->count = failed.load() ? 0 : reader.read(b->points.data(), opt.batch_size);
+                }
+                catch (const std::exception &e)
+                {
+                    error = e.what();
+                    failed.store(true);
+                    b->count = 0;
+                }
+                b->last = b->count < opt.batch_size;
+                b->parsed = clock_type::now();
+                parsed.push(b);
+                if (b->last)
+                    break;
+            }
+            input_bytes = reader.bytes();
+        });
+
+        std::thread evaluator_thread([&] {
+            while (true)
+            {
+                batch *b = parsed.pop();
+                eval.run(*b);
+                evaluated.push(b);
+                if (b->last)
+                    break;
+            }
+        });
+
+        // zapis w wątku głównym
+        latency_histogram latency;
+        std::uint64_t points = 0;
+        std::vector<char> text;
+        bool write_failed = false;
+        while (true)
+        {
+            batch *b = evaluated.pop();
+            text.clear();
+            char number[32];
+            for (size_t i = 0; i < b->count; ++i)
+            {
+                for (size_t j = 0; j < k; ++j)
+                {
+                    auto res = std::to_chars(number, number + sizeof(number), b->values[i * k + j]);
+                    text.insert(text.end(), number, res.ptr);
+                    text.push_back(j + 1 == k ? '\n' : ' ');
+                }
+            }
+            if (!write_failed && std::fwrite(text.data(), 1, text.size(), out) != text.size())
+                write_failed = true;
+            points += b->count;
+            if (b->count != 0)
+                latency.add(clock_type::now() - b->parsed);
+            bool last = b->last;
+            free_batches.push(b);
+            if (last)
+                break;
+        }
+
+        reader_thread.join();
+        evaluator_thread.join();
+        if (std::fflush(out) != 0)
+            write_failed = true;
+        if (out != stdout)
+            std::fclose(out);
+        auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+        if (opt.stats)
+        {
+            std::fprintf(stderr,
+                         "polyeval: %llu points x %zu polys in %.3f s\n"
+                         "  throughput: %.0f points/s, %.1f MB/s input\n"
+                         "  batch latency (us): p50 <= %lld, p99 <= %lld, max %lld\n",
+                         static_cast<unsigned long long>(points), k, elapsed,
+                         elapsed > 0 ? double(points) / elapsed : 0.0,
+                         elapsed > 0 ? double(input_bytes) / elapsed / 1e6 : 0.0,
+                         static_cast<long long>(latency.quantile(0.5)),
+                         static_cast<long long>(latency.quantile(0.99)),
+                         static_cast<long long>(latency.max_us()));
+        }
+        if (failed)
+        {
+            std::fprintf(stderr, "polyeval: %s\n", error.c_str());
+            return 1;
+        }
+        if (write_failed)
+        {
+            std::fputs("polyeval: write error\n", stderr);
+            return 1;
+        }
+        return 0;
+    }
+
+    // rozmiar wielomianu w czasie kompilacji: najmniejszy z listy, który wystarcza
+    template <size_t N, size_t... Rest>
+    int dispatch(size_t needed, const options &opt, const std::vector<std::vector<double>> &coeffs)
+    {
+        if (needed <= N)
+            return run<N>(opt, coeffs);
+        if constexpr (sizeof...(Rest) > 0)
+            return dispatch<Rest...>(needed, opt, coeffs);
+        else
+            throw std::runtime_error("polynomials with more than " + std::to_string(N) + " coefficients are not supported");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opt = parse_options(argc, argv);
+    std::string cache = poly_autotune::default_cache_path();
+    if (opt.tune)
+    {
+        poly_tuning_profile profile = poly_autotune::measure();
+        if (!poly_autotune::save(profile, cache))
+        {
+            std::fprintf(stderr, "polyeval: cannot write %s\n", cache.c_str());
+            return 1;
+        }
+        std::printf("karatsuba_cutoff %zu\nestrin_cutoff %zu\n", profile.karatsuba_cutoff, profile.estrin_cutoff);
+        return 0;
+    }
+    if (auto profile = poly_autotune::load(cache))
+        profile->apply();
+    try
+    {
+        auto coeffs = read_polys(opt.polys_path);
+        size_t needed = 1;
+        for (const auto &c : coeffs)
+            needed = std::max(needed, c.size());
+        return dispatch<4, 8, 16, 32, 64, 128>(needed, opt, coeffs);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "polyeval: %s\n", e.what());
+        return 1;
+    }
+}
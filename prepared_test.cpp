@@ -0,0 +1,114 @@
+#include "poly_prepared.h"
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace {
+    template <typename T, std::size_t N>
+    poly<T, N> sample(std::size_t seed) {
+        poly<T, N> p;
+        for (std::size_t i = 0; i < N; ++i)
+            p[i] = static_cast<T>((i * 7 + seed * 13) % 23) - T(11);
+        return p;
+    }
+
+    template <typename A, typename B>
+    bool same(const A& a, const B& b) {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+
+    // iloczyn z przygotowanym jądrem równy zwykłemu, w obu kolejnościach
+    template <typename T, std::size_t N, std::size_t M>
+    void check() {
+        auto k = sample<T, M>(1);
+        prepared kernel(k);
+        for (std::size_t seed = 2; seed < 5; ++seed) {
+            auto x = sample<T, N>(seed);
+            auto expected = x * k;
+            auto y = x * kernel;
+            static_assert(std::is_same_v<decltype(y), decltype(expected)>);
+            assert(same(y, expected));
+            assert(same(kernel * x, k * x));
+        }
+    }
+
+    void test_sizes() {
+        check<long long, 64, 64>();
+        check<long long, 200, 64>();
+        check<long long, 1000, 77>();
+        check<int, 33, 33>();
+        // krótszy drugi czynnik i małe jądro - zwykłe operator*
+        check<long long, 10, 64>();
+        check<long long, 100, 5>();
+        // współczynniki całkowitoliczbowe sumują się w double dokładnie
+        check<double, 300, 100>();
+    }
+
+    void test_mixed() {
+        auto k = sample<long long, 50>(1);
+        auto x = sample<int, 120>(2);
+        prepared kernel(k);
+        assert(same(x * kernel, x * k));
+        assert(same(kernel * x, k * x));
+    }
+
+    // drzewo zostaje poprawne po zmianie progu
+    void test_cutoff_change() {
+        auto k = sample<long long, 100>(1);
+        auto x = sample<long long, 300>(2);
+        prepared kernel(k);
+        std::size_t saved = poly_tuning::karatsuba_cutoff;
+        poly_tuning::karatsuba_cutoff = 4;
+        assert(same(x * kernel, x * k));
+        prepared fine(k);
+        poly_tuning::karatsuba_cutoff = saved;
+        assert(same(x * fine, x * k));
+    }
+
+    // jeden przygotowany czynnik w wielu wątkach naraz (pamięć pomocnicza na wątek)
+    void test_threads() {
+        auto k = sample<long long, 64>(1);
+        prepared kernel(k);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 4; ++t)
+            threads.emplace_back([&kernel, &k, t] {
+                for (std::size_t seed = 0; seed < 50; ++seed) {
+                    auto x = sample<long long, 200>(seed + 10 * t);
+                    assert(same(x * kernel, x * k));
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+    }
+
+    // działa też w czasie kompilacji
+    constexpr bool constexpr_prepared() {
+        poly<long long, 40> k, x;
+        for (std::size_t i = 0; i < 40; ++i) {
+            k[i] = static_cast<long long>(i % 5) - 2;
+            x[i] = static_cast<long long>(i % 3) + 1;
+        }
+        prepared kernel(k);
+        auto y = x * kernel, z = x * k;
+        for (std::size_t i = 0; i < y.size(); ++i)
+            if (y[i] != z[i])
+                return false;
+        return true;
+    }
+
+    static_assert(constexpr_prepared());
+}
+
+int main() {
+    test_sizes();
+    test_mixed();
+    test_cutoff_change();
+    test_threads();
+}
@@ -0,0 +1,267 @@
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "poly.h"
+
+// Ułamek o liczniku i mianowniku typu całkowitego T ze znakiem, do użycia
+// jako współczynnik wielomianu (poly<Rational<long long>, N>).
+//
+// Skracanie przez NWD jest leniwe: działania arytmetyczne go nie wykonują
+// (np. suma ułamków o tym samym mianowniku to jedno dodawanie), a postać
+// nieskracalna liczona jest dopiero przy porównaniu, wypisywaniu, haszowaniu
+// albo gdy wynik nie mieściłby się w T. Dopiero gdy nie mieści się także po
+// skróceniu, działanie zgłasza std::overflow_error.
+template <std::signed_integral T>
+class Rational
+{
+public:
+    constexpr Rational() : num(0), den(1) {}
+
+    // liczba całkowita; niejawna, tak jak dla typów wbudowanych
+    template <std::integral U>
+    constexpr Rational(U n) : num(static_cast<T>(n)), den(1) {}
+
+    constexpr Rational(T n, T d) : num(n), den(d)
+    {
+        if (d == 0)
+            throw std::domain_error("Rational: zero denominator");
+        if (d < 0)
+        {
+            num = checked_neg(num);
+            den = checked_neg(den);
+        }
+    }
+
+    // poszerzenie typu licznika i mianownika
+    template <std::signed_integral U>
+        requires(!std::is_same_v<U, T>)
+    constexpr explicit(sizeof(U) > sizeof(T)) Rational(const Rational<U> &other)
+        : num(static_cast<T>(other.numerator())), den(static_cast<T>(other.denominator())) {}
+
+    // licznik i mianownik w postaci, w jakiej są przechowywane (niekoniecznie skróconej)
+    constexpr T numerator() const { return num; }
+    constexpr T denominator() const { return den; }
+
+    // postać nieskracalna z dodatnim mianownikiem
+    constexpr Rational reduced() const
+    {
+        Rational r = *this;
+        r.reduce();
+        return r;
+    }
+
+    constexpr void reduce()
+    {
+        T g = gcd(num, den);
+        if (g > 1)
+        {
+            num /= g;
+            den /= g;
+        }
+    }
+
+    template <std::floating_point F>
+    constexpr explicit operator F() const
+    {
+        return static_cast<F>(num) / static_cast<F>(den);
+    }
+
+    // OPERATORY ARYTMETYCZNE
+
+    constexpr Rational operator-() const
+    {
+        Rational r;
+        r.num = checked_neg(num);
+        r.den = den;
+        return r;
+    }
+
+    friend constexpr Rational operator+(const Rational &a, const Rational &b) { return add(a, b, false); }
+    friend constexpr Rational operator-(const Rational &a, const Rational &b) { return add(a, b, true); }
+
+    friend constexpr Rational operator*(const Rational &a, const Rational &b)
+    {
+        Rational r;
+        if (!mul_overflow(a.num, b.num, r.num) && !mul_overflow(a.den, b.den, r.den))
+            return r;
+        // skracamy czynniki, potem na krzyż, i próbujemy jeszcze raz
+        Rational x = a.reduced(), y = b.reduced();
+        T g1 = gcd(x.num, y.den), g2 = gcd(y.num, x.den);
+        r.num = checked_mul(x.num / g1, y.num / g2);
+        r.den = checked_mul(x.den / g2, y.den / g1);
+        return r;
+    }
+
+    friend constexpr Rational operator/(const Rational &a, const Rational &b)
+    {
+        if (b.num == 0)
+            throw std::domain_error("Rational: division by zero");
+        Rational inv;
+        inv.num = b.num < 0 ? checked_neg(b.den) : b.den;
+        inv.den = b.num < 0 ? checked_neg(b.num) : b.num;
+        return a * inv;
+    }
+
+    constexpr Rational &operator+=(const Rational &other) { return *this = *this + other; }
+    constexpr Rational &operator-=(const Rational &other) { return *this = *this - other; }
+    constexpr Rational &operator*=(const Rational &other) { return *this = *this * other; }
+    constexpr Rational &operator/=(const Rational &other) { return *this = *this / other; }
+
+    // PORÓWNANIA (na postaciach nieskracalnych)
+
+    friend constexpr bool operator==(const Rational &a, const Rational &b)
+    {
+        if (a.den == b.den)
+            return a.num == b.num;
+        Rational x = a.reduced(), y = b.reduced();
+        return x.num == y.num && x.den == y.den;
+    }
+
+    friend constexpr std::strong_ordering operator<=>(const Rational &a, const Rational &b)
+    {
+        if (a.den == b.den)
+            return a.num <=> b.num;
+        Rational x = a.reduced(), y = b.reduced();
+        T g = gcd(x.den, y.den);
+        return checked_mul(x.num, y.den / g) <=> checked_mul(y.num, x.den / g);
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const Rational &r)
+    {
+        Rational x = r.reduced();
+        os << x.num;
+        if (x.den != 1)
+            os << '/' << x.den;
+        return os;
+    }
+
+private:
+    T num;
+    // zawsze dodatni
+    T den;
+
+    using unsigned_type = std::make_unsigned_t<T>;
+
+    static constexpr unsigned_type magnitude(T x)
+    {
+        return x < 0 ? unsigned_type(0) - static_cast<unsigned_type>(x) : static_cast<unsigned_type>(x);
+    }
+
+    // NWD binarnym algorytmem Steina; gcd(0, d) = d
+    static constexpr T gcd(T a, T b)
+    {
+        unsigned_type x = magnitude(a), y = magnitude(b);
+        if (x == 0)
+            return static_cast<T>(y);
+        if (y == 0)
+            return static_cast<T>(x);
+        int shift = std::countr_zero(x | y);
+        x >>= std::countr_zero(x);
+        do
+        {
+            y >>= std::countr_zero(y);
+            if (x > y)
+            {
+                unsigned_type t = x;
+                x = y;
+                y = t;
+            }
+            y -= x;
+        } while (y != 0);
+        return static_cast<T>(x << shift);
+    }
+
+    static constexpr bool mul_overflow(T a, T b, T &out) { return __builtin_mul_overflow(a, b, &out); }
+    static constexpr bool add_overflow(T a, T b, T &out) { return __builtin_add_overflow(a, b, &out); }
+    static constexpr bool sub_overflow(T a, T b, T &out) { return __builtin_sub_overflow(a, b, &out); }
+
+    static constexpr T checked_mul(T a, T b)
+    {
+        T r;
+        if (mul_overflow(a, b, r))
+            throw std::overflow_error("Rational: overflow");
+        return r;
+    }
+
+    static constexpr T checked_neg(T a)
+    {
+        T r;
+        if (sub_overflow(T(0), a, r))
+            throw std::overflow_error("Rational: overflow");
+        return r;
+    }
+
+    // a.num / a.den ± b.num / b.den bez skracania; skracamy dopiero, gdy
+    // wynik się nie mieści
+    static constexpr bool try_add(const Rational &a, const Rational &b, bool subtract, Rational &r)
+    {
+        T x, y;
+        if (a.den == b.den)
+        {
+            r.den = a.den;
+            return !(subtract ? sub_overflow(a.num, b.num, r.num) : add_overflow(a.num, b.num, r.num));
+        }
+        return !mul_overflow(a.num, b.den, x) && !mul_overflow(b.num, a.den, y) &&
+               !mul_overflow(a.den, b.den, r.den) &&
+               !(subtract ? sub_overflow(x, y, r.num) : add_overflow(x, y, r.num));
+    }
+
+    static constexpr Rational add(const Rational &a, const Rational &b, bool subtract)
+    {
+        Rational r;
+        if (try_add(a, b, subtract, r))
+            return r;
+        // wspólny mianownik NWW zamiast iloczynu, na postaciach skróconych
+        Rational x = a.reduced(), y = b.reduced();
+        T g = gcd(x.den, y.den);
+        Rational xs, ys;
+        xs.num = checked_mul(x.num, y.den / g);
+        ys.num = checked_mul(y.num, x.den / g);
+        xs.den = ys.den = checked_mul(x.den / g, y.den);
+        if (!try_add(xs, ys, subtract, r))
+            throw std::overflow_error("Rational: overflow");
+        r.reduce();
+        return r;
+    }
+};
+
+template <typename T, typename U>
+struct std::common_type<Rational<T>, Rational<U>>
+{
+    using type = Rational<std::common_type_t<T, U>>;
+};
+
+template <typename T, std::integral U>
+    requires(!std::is_same_v<U, bool>)
+struct std::common_type<Rational<T>, U>
+{
+    using type = Rational<std::make_signed_t<std::common_type_t<T, U>>>;
+};
+
+template <typename T, std::integral U>
+    requires(!std::is_same_v<U, bool>)
+struct std::common_type<U, Rational<T>>
+{
+    using type = Rational<std::make_signed_t<std::common_type_t<T, U>>>;
+};
+
+template <typename T>
+struct std::hash<Rational<T>>
+{
+    size_t operator()(const Rational<T> &r) const noexcept
+    {
+        Rational<T> x = r.reduced();
+        return detail::hash_mix(std::hash<T>{}(x.numerator()), std::hash<T>{}(x.denominator()));
+    }
+};
+
+#endif // RATIONAL_H
@@ -0,0 +1,105 @@
+#include "rational.h"
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace {
+    using Q = Rational<long long>;
+
+    std::string str(const Q& q) {
+        std::ostringstream os;
+        os << q;
+        return os.str();
+    }
+
+    static_assert(std::is_same_v<std::common_type_t<Q, int>, Q>);
+    static_assert(std::is_same_v<std::common_type_t<int, Rational<int>>, Rational<int>>);
+    static_assert(std::is_same_v<std::common_type_t<Rational<int>, Q>, Q>);
+    static_assert(std::is_convertible_v<int, Q>);
+    static_assert(std::is_convertible_v<Rational<int>, Q>);
+    static_assert(!std::is_convertible_v<Q, Rational<int>>);
+    static_assert(Q(1, 2) + Q(1, 3) == Q(5, 6));
+    static_assert(Q(2, 4) == Q(1, 2) && Q(1, 3) < Q(1, 2));
+
+    void test_lazy() {
+        // suma o wspólnym mianowniku nie skraca
+        Q a(1, 4);
+        Q s = a + a;
+        assert(s.numerator() == 2 && s.denominator() == 4);
+        assert(s == Q(1, 2));
+        assert(str(s) == "1/2");
+        assert(str(Q(6, -3)) == "-2");
+        assert(s.reduced().numerator() == 1);
+
+        Q p = Q(2, 3) * Q(3, 4);
+        assert(p.numerator() == 6 && p.denominator() == 12);
+        assert(p == Q(1, 2));
+        assert(Q(1, 2) / Q(-1, 4) == -2);
+        assert(Q(3, 7) - Q(3, 7) == 0);
+        assert(static_cast<double>(Q(1, 4)) == 0.25);
+    }
+
+    void test_overflow() {
+        // iloczyn nie mieści się bez skracania na krzyż
+        const long long big = std::numeric_limits<long long>::max() / 3;
+        Q x(big, 7), y(7, big);
+        assert(x * y == 1);
+
+        // powtarzane mnożenie przez 2/2 nie przepełnia, bo w razie potrzeby skracamy
+        Q h(1, 3);
+        for (int i = 0; i < 200; ++i)
+            h = h * Q(2, 2) + Q(0, 5);
+        assert(h == Q(1, 3));
+
+        // czynnik nieskrócony: 17433922005/3486784401 = 5, a 5 * 2^40 się mieści
+        long long p20 = 3486784401LL;
+        Q five = Q(2, p20) + Q(5 * p20 - 2, p20);
+        assert(five.denominator() == p20);
+        assert(five * Q(1LL << 40) == Q(5LL << 40));
+        poly<Q, 2> lin(five, Q(1));
+        assert((lin * Q(1LL << 40))[0] == Q(5LL << 40));
+
+        bool thrown = false;
+        try {
+            Q z = Q(big) * Q(big);
+            (void)z;
+        } catch (const std::overflow_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        thrown = false;
+        try {
+            Q(1, 0);
+        } catch (const std::domain_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    void test_poly() {
+        // (1/2 + x/3)^2 = 1/4 + x/3 + x^2/9
+        poly<Q, 2> p(Q(1, 2), Q(1, 3));
+        auto sq = p * p;
+        assert(sq[0] == Q(1, 4) && sq[1] == Q(1, 3) && sq[2] == Q(1, 9));
+        assert(p.at(3) == Q(3, 2));
+        assert(p.at(Q(3, 2)) == 1);
+
+        poly<Q, 3> q = poly<int, 2>(1, 2);
+        q += p;
+        assert(q[0] == Q(3, 2) && q[1] == Q(7, 3) && q[2] == 0);
+        auto r = p * 6;
+        assert(r[0] == 3 && r[1] == 2);
+        assert(std::hash<Q>{}(Q(2, 4)) == std::hash<Q>{}(Q(1, 2)));
+    }
+}
+
+int main() {
+    test_lazy();
+    test_overflow();
+    test_poly();
+}
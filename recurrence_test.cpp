@@ -0,0 +1,92 @@
+#include "poly_recurrence.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    using u64 = std::uint64_t;
+
+    // wyrazy liczone wprost z definicji (arytmetyka modulo 2^64)
+    template <std::size_t D>
+    std::vector<u64> naive(const std::array<u64, D>& c, const std::array<u64, D>& init, std::size_t count) {
+        std::vector<u64> a(init.begin(), init.end());
+        while (a.size() < count) {
+            u64 next = 0;
+            for (std::size_t i = 0; i < D; ++i)
+                next += c[i] * a[a.size() - 1 - i];
+            a.push_back(next);
+        }
+        return a;
+    }
+
+    // F(n) i F(n + 1) modulo 2^64 metodą podwajania
+    std::pair<u64, u64> fib_pair(u64 n) {
+        if (n == 0)
+            return {0, 1};
+        auto [f, g] = fib_pair(n / 2);
+        u64 even = f * (2 * g - f);
+        u64 odd = f * f + g * g;
+        return n % 2 == 0 ? std::pair{even, odd} : std::pair{odd, even + odd};
+    }
+
+    constexpr linear_recurrence<long long, 2> fibonacci({1, 1}, {0, 1});
+    static_assert(fibonacci(0) == 0 && fibonacci(1) == 1 && fibonacci(10) == 55);
+    static_assert(fibonacci(90) == 2880067194370816120ll);
+
+    void test_small_orders() {
+        linear_recurrence<u64, 1> geometric({3}, {2});
+        assert(geometric(0) == 2 && geometric(5) == 2 * 243);
+
+        std::array<u64, 3> c{1, 1, 1}, init{0, 0, 1};
+        linear_recurrence<u64, 3> tribonacci(c, init);
+        auto expected = naive(c, init, 500);
+        for (std::size_t n = 0; n < expected.size(); ++n)
+            assert(tribonacci(n) == expected[n]);
+    }
+
+    void test_large_index() {
+        linear_recurrence<u64, 2> fib({1, 1}, {0, 1});
+        for (u64 n : {u64(1000), u64(123456789), u64(1000000000000000000ull), ~u64(0)})
+            assert(fib(n) == fib_pair(n).first);
+    }
+
+    // rząd powyżej progu Karatsuby
+    void test_high_order() {
+        constexpr std::size_t D = 70;
+        std::array<u64, D> c, init;
+        u64 seed = 1;
+        for (std::size_t i = 0; i < D; ++i) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            c[i] = seed >> 40;
+            init[i] = seed >> 20;
+        }
+        linear_recurrence<u64, D> rec(c, init);
+        auto expected = naive(c, init, 3000);
+        for (std::size_t n : {0, 1, 69, 70, 71, 140, 1000, 2047, 2999})
+            assert(rec(n) == expected[n]);
+
+        std::vector<u64> ns{2999, 0, 70, 1234, 69, 2048, 2999};
+        auto batch = rec.terms(ns);
+        for (std::size_t k = 0; k < ns.size(); ++k)
+            assert(batch[k] == expected[ns[k]]);
+    }
+
+    void test_batch() {
+        linear_recurrence<u64, 2> fib({1, 1}, {0, 1});
+        std::vector<u64> ns{0, 1, 2, 15, 16, 17, 255, 256, 1000000000000000000ull, ~u64(0), 12345};
+        auto batch = fib.terms(ns);
+        for (std::size_t k = 0; k < ns.size(); ++k)
+            assert(batch[k] == fib_pair(ns[k]).first);
+
+        assert(fib.terms(std::vector<u64>{0, 0})[1] == 0);
+        assert(fib.terms(std::vector<u64>{}).empty());
+    }
+}
+
+int main() {
+    test_small_orders();
+    test_large_index();
+    test_high_order();
+    test_batch();
+}
@@ -0,0 +1,142 @@
+#define POLY_PARALLEL
+#include "poly_resultant.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    using i64 = long long;
+
+    // wyznacznik macierzy Sylvestera metodą Bareissa (dokładnie w liczbach całkowitych)
+    i64 sylvester(const std::vector<i64>& a, std::size_t m, const std::vector<i64>& b, std::size_t n) {
+        std::size_t size = m + n;
+        if (size == 0)
+            return 1;
+        std::vector<std::vector<i64>> s(size, std::vector<i64>(size));
+        for (std::size_t r = 0; r < n; ++r)
+            for (std::size_t i = 0; i <= m; ++i)
+                s[r][r + i] = a[m - i];
+        for (std::size_t r = 0; r < m; ++r)
+            for (std::size_t i = 0; i <= n; ++i)
+                s[n + r][r + i] = b[n - i];
+
+        i64 sign = 1, prev = 1;
+        for (std::size_t k = 0; k + 1 < size; ++k) {
+            if (s[k][k] == 0) {
+                std::size_t r = k + 1;
+                while (r < size && s[r][k] == 0)
+                    ++r;
+                if (r == size)
+                    return 0;
+                std::swap(s[k], s[r]);
+                sign = -sign;
+            }
+            for (std::size_t i = k + 1; i < size; ++i)
+                for (std::size_t j = k + 1; j < size; ++j)
+                    s[i][j] = (s[i][j] * s[k][k] - s[i][k] * s[k][j]) / prev;
+            prev = s[k][k];
+        }
+        return sign * s[size - 1][size - 1];
+    }
+
+    template <std::size_t N>
+    std::vector<i64> coeffs(const poly<i64, N>& p) {
+        return std::vector<i64>(p.data(), p.data() + N);
+    }
+
+    std::size_t degree(const std::vector<i64>& a) {
+        std::size_t d = a.size() - 1;
+        while (d > 0 && a[d] == 0)
+            --d;
+        return d;
+    }
+
+    void test_univariate() {
+        // Res(x^2 - 1, x - 2) = (2 - 1)(2 + 1) = 3
+        assert(resultant(poly<i64, 3>(-1, 0, 1), poly<i64, 2>(-2, 1)) == 3);
+        assert(resultant(poly<i64, 2>(-2, 1), poly<i64, 3>(-1, 0, 1)) == 3);
+        // wspólny pierwiastek
+        assert(resultant(poly<i64, 3>(-1, 0, 1), poly<i64, 2>(1, 1)) == 0);
+        assert(resultant(poly<i64, 2>(5), poly<i64, 3>(1, 2, 3)) == 25);
+        assert(resultant(poly<i64, 2>(), poly<i64, 3>(1, 2, 3)) == 0);
+
+        // b^2 - 4ac i wyróżnik sześcienny -4p^3 - 27q^2
+        assert(discriminant(poly<i64, 3>(3, 5, 2)) == 25 - 24);
+        assert(discriminant(poly<i64, 4>(-1, -2, 0, 1)) == -4 * -8 - 27 * 1);
+        assert(discriminant(poly<i64, 4>(7)) == 1);
+        assert(discriminant(poly<double, 3>(1.0, 2.0, 1.0)) == 0.0);
+
+        std::uint64_t seed = 7;
+        auto next = [&] {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<i64>(seed >> 61) - 3;
+        };
+        for (int trial = 0; trial < 200; ++trial) {
+            poly<i64, 6> p;
+            poly<i64, 5> q;
+            for (std::size_t i = 0; i < 6; ++i)
+                p[i] = next();
+            for (std::size_t i = 0; i < 5; ++i)
+                q[i] = next();
+            auto a = coeffs(p), b = coeffs(q);
+            if ((a[degree(a)] == 0) || (b[degree(b)] == 0))
+                continue;
+            assert(resultant(p, q) == sylvester(a, degree(a), b, degree(b)));
+        }
+    }
+
+    // Res_x w każdym punkcie y0 musi się zgadzać z wyznacznikiem Sylvestera
+    // podstawienia, liczonym dla formalnych stopni w x
+    template <std::size_t M1, std::size_t N1, std::size_t M2, std::size_t N2>
+    void check_bivariate(const poly<poly<i64, M1>, N1>& p, const poly<poly<i64, M2>, N2>& q) {
+        auto r = resultant(p, q);
+        static_assert(r.size() == (N1 - 1) * (M2 - 1) + (N2 - 1) * (M1 - 1) + 1);
+        for (i64 y0 = -4; y0 <= 6; ++y0) {
+            std::vector<i64> a(N1), b(N2);
+            for (std::size_t i = 0; i < N1; ++i)
+                a[i] = p[i].at(y0);
+            for (std::size_t i = 0; i < N2; ++i)
+                b[i] = q[i].at(y0);
+            assert(r.at(y0) == sylvester(a, N1 - 1, b, N2 - 1));
+        }
+    }
+
+    void test_bivariate() {
+        // okrąg x^2 + y^2 - 1 i prosta x - y: Res_x = 2y^2 - 1
+        poly<poly<i64, 3>, 3> circle(poly<i64, 3>(-1, 0, 1), 0, 1);
+        poly<poly<i64, 2>, 2> line(poly<i64, 2>(0, -1), 1);
+        auto r = resultant(circle, line);
+        assert(r[0] == -1 && r[1] == 0 && r[2] == 2 && r[3] == 0);
+        check_bivariate(circle, line);
+
+        // współczynnik wiodący w x znika w niektórych punktach y
+        poly<poly<i64, 3>, 3> p(poly<i64, 3>(1, 2), poly<i64, 3>(0, 1, -1), poly<i64, 3>(-2, 1));
+        poly<poly<i64, 2>, 4> q(poly<i64, 2>(3), poly<i64, 2>(1, 1), 0, poly<i64, 2>(0, 1));
+        check_bivariate(p, q);
+        check_bivariate(q, p);
+    }
+
+    void test_bivariate_discriminant() {
+        // x^2 + y x + 1: wyróżnik y^2 - 4
+        poly<poly<i64, 2>, 3> p(1, poly<i64, 2>(0, 1), 1);
+        auto d = discriminant(p);
+        assert(d[0] == -4 && d[1] == 0 && d[2] == 1);
+
+        // y x^2 - x + y: 1 - 4y^2, dzielenie przez lc_x = y
+        poly<poly<i64, 2>, 3> q(poly<i64, 2>(0, 1), -1, poly<i64, 2>(0, 1));
+        auto e = discriminant(q);
+        assert(e[0] == 1 && e[1] == 0 && e[2] == -4);
+
+        // x^3 - y: -27 y^2
+        poly<poly<i64, 2>, 4> c(poly<i64, 2>(0, -1), 0, 0, 1);
+        auto f = discriminant(c);
+        assert(f[0] == 0 && f[1] == 0 && f[2] == -27);
+    }
+}
+
+int main() {
+    test_univariate();
+    test_bivariate();
+    test_bivariate_discriminant();
+}
@@ -0,0 +1,366 @@
+#ifndef RING_POLY_H
+#define RING_POLY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+#include "poly.h"
+
+// Wielomiany w pierścieniu ilorazowym Z_Q[x]/(x^N + 1) (negacykliczny) albo
+// Z_Q[x]/(x^N - 1) (cykliczny), dla N będącego potęgą dwójki i pierwszego Q
+// takiego, że w Z_Q istnieje pierwiastek z jedności rzędu 2N (odpowiednio N).
+//
+// Mnożenie to NTT rozmiaru N, iloczyn po współrzędnych i odwrotne NTT - bez
+// iloczynu rozmiaru 2N - 1 i ręcznego składania górnej połowy. Tablice
+// pierwiastków liczone są w czasie kompilacji. Wynik mnożenia zostaje
+// w dziedzinie NTT, więc kolejne działania (+, -, *) nie przeliczają go
+// tam i z powrotem; to_poly(), == i from_ntt() wracają do współczynników.
+
+enum class ring_kind
+{
+    negacyclic, // x^N + 1
+    cyclic      // x^N - 1
+};
+
+namespace detail
+{
+    template <typename T>
+    using ring_wide_t = std::conditional_t<(sizeof(T) <= 4), std::uint64_t, unsigned __int128>;
+
+    template <typename T>
+    constexpr T mul_mod(T a, T b, T q)
+    {
+        return static_cast<T>(static_cast<ring_wide_t<T>>(a) * b % q);
+    }
+
+    template <typename T>
+    constexpr T pow_mod(T a, std::uint64_t e, T q)
+    {
+        T r = 1 % q;
+        while (e > 0)
+        {
+            if (e & 1)
+                r = mul_mod(r, a, q);
+            a = mul_mod(a, a, q);
+            e >>= 1;
+        }
+        return r;
+    }
+
+    // test Millera-Rabina; dla tych świadków deterministyczny do 2^64
+    template <typename T>
+    constexpr bool is_prime(T q)
+    {
+        if (q < 2)
+            return false;
+        for (T p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+            if (q % p == 0)
+                return q == p;
+        T d = q - 1;
+        int s = std::countr_zero(d);
+        d >>= s;
+        for (T a : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+        {
+            T x = pow_mod(a, d, q);
+            if (x == 1 || x == q - 1)
+                continue;
+            bool composite = true;
+            for (int i = 1; i < s && composite; ++i)
+            {
+                x = mul_mod(x, x, q);
+                composite = x != q - 1;
+            }
+            if (composite)
+                return false;
+        }
+        return true;
+    }
+
+    // pierwiastek z jedności rzędu dokładnie order (potęga dwójki) modulo q
+    template <typename T>
+    constexpr T root_of_unity(T q, std::uint64_t order)
+    {
+        if (order == 1)
+            return 1;
+        for (T g = 2;; ++g)
+        {
+            T w = pow_mod(g, (q - 1) / order, q);
+            if (pow_mod(w, order / 2, q) == q - 1)
+                return w;
+        }
+    }
+
+    // Tablice dla ring_poly: potęgi pierwiastka rzędu N (i odwrotności) dla
+    // motylków oraz, dla przypadku negacyklicznego, potęgi psi rzędu 2N:
+    // a(x) mod x^N + 1 po podstawieniu x = psi y staje się cykliczne w y.
+    template <typename T, size_t N, T Q, ring_kind K>
+    struct ring_tables
+    {
+        static constexpr T psi = root_of_unity<T>(Q, K == ring_kind::negacyclic ? 2 * N : N);
+        static constexpr T omega = K == ring_kind::negacyclic ? mul_mod(psi, psi, Q) : psi;
+        static constexpr T n_inv = pow_mod<T>(N % Q, Q - 2, Q);
+
+        std::array<T, N / 2 + 1> roots{};
+        std::array<T, N / 2 + 1> inv_roots{};
+        // twist[i] = psi^i, untwist[i] = psi^-i / N (dla cyklicznego puste)
+        std::array<T, K == ring_kind::negacyclic ? N : 0> twist{};
+        std::array<T, K == ring_kind::negacyclic ? N : 0> untwist{};
+
+        constexpr ring_tables()
+        {
+            T omega_inv = pow_mod(omega, Q - 2, Q);
+            roots[0] = inv_roots[0] = 1;
+            for (size_t j = 1; j <= N / 2; ++j)
+            {
+                roots[j] = mul_mod(roots[j - 1], omega, Q);
+                inv_roots[j] = mul_mod(inv_roots[j - 1], omega_inv, Q);
+            }
+            if constexpr (K == ring_kind::negacyclic)
+            {
+                T psi_inv = pow_mod(psi, Q - 2, Q);
+                twist[0] = 1;
+                untwist[0] = n_inv;
+                for (size_t i = 1; i < N; ++i)
+                {
+                    twist[i] = mul_mod(twist[i - 1], psi, Q);
+                    untwist[i] = mul_mod(untwist[i - 1], psi_inv, Q);
+                }
+            }
+        }
+
+        static constexpr const ring_tables &get()
+        {
+            return instance;
+        }
+
+    private:
+        static const ring_tables instance;
+    };
+
+    template <typename T, size_t N, T Q, ring_kind K>
+    inline constexpr ring_tables<T, N, Q, K> ring_tables<T, N, Q, K>::instance{};
+}
+
+template <std::unsigned_integral T, size_t N, T Modulus, ring_kind Kind = ring_kind::negacyclic>
+class ring_poly
+{
+    static_assert(std::has_single_bit(N), "N musi być potęgą dwójki");
+    static_assert(sizeof(T) <= 8, "obsługiwane są moduły co najwyżej 64-bitowe");
+    static_assert(Modulus <= std::numeric_limits<T>::max() / 2, "suma dwóch reszt musi mieścić się w T");
+    static_assert(detail::is_prime(Modulus), "moduł musi być liczbą pierwszą");
+    static_assert((Modulus - 1) % (Kind == ring_kind::negacyclic ? 2 * N : N) == 0,
+                  "brak pierwiastka z jedności rzędu 2N (N dla cyklicznego) modulo Modulus");
+
+    using tables = detail::ring_tables<T, N, Modulus, Kind>;
+
+public:
+    using value_type = T;
+    static constexpr T modulus = Modulus;
+    static constexpr ring_kind kind = Kind;
+
+    constexpr ring_poly() : c(), transformed(false) {}
+
+    // Z dowolnego wielomianu całkowitego: współczynniki modulo Modulus,
+    // wyrazy stopnia >= N składane zgodnie z x^N = -1 (albo 1).
+    template <std::integral U, size_t M, typename S>
+    constexpr ring_poly(const poly<U, M, S> &p) : c(), transformed(false)
+    {
+        for (size_t i = 0; i < M; ++i)
+        {
+            T v = reduce(p[i]);
+            T &slot = c[i % N];
+            slot = Kind == ring_kind::negacyclic && (i / N) % 2 == 1 ? sub(slot, v) : add(slot, v);
+        }
+    }
+
+    static constexpr size_t size() { return N; }
+
+    // Współczynnik albo - gdy in_ntt() - wartość w dziedzinie NTT.
+    constexpr const T &operator[](size_t i) const { return c[i]; }
+
+    constexpr bool in_ntt() const { return transformed; }
+
+    // Przejście do dziedziny NTT; nic nie robi, gdy już w niej jesteśmy.
+    constexpr ring_poly &to_ntt()
+    {
+        if (!transformed)
+        {
+            if constexpr (Kind == ring_kind::negacyclic)
+                for (size_t i = 0; i < N; ++i)
+                    c[i] = mul(c[i], tables::get().twist[i]);
+            forward();
+            transformed = true;
+        }
+        return *this;
+    }
+
+    // Powrót do współczynników.
+    constexpr ring_poly &from_ntt()
+    {
+        if (transformed)
+        {
+            inverse();
+            if constexpr (Kind == ring_kind::negacyclic)
+                for (size_t i = 0; i < N; ++i)
+                    c[i] = mul(c[i], tables::get().untwist[i]);
+            else
+                for (size_t i = 0; i < N; ++i)
+                    c[i] = mul(c[i], tables::n_inv);
+            transformed = false;
+        }
+        return *this;
+    }
+
+    constexpr poly<T, N> to_poly() const
+    {
+        ring_poly r = *this;
+        r.from_ntt();
+        poly<T, N> res;
+        for (size_t i = 0; i < N; ++i)
+            res[i] = r.c[i];
+        return res;
+    }
+
+    constexpr explicit operator poly<T, N>() const { return to_poly(); }
+
+    // OPERATORY ARYTMETYCZNE
+    // Dodawanie i odejmowanie działa w obu dziedzinach; wynik jest w dziedzinie
+    // lewego argumentu.
+
+    constexpr ring_poly &operator+=(ring_poly other)
+    {
+        other.match(transformed);
+        for (size_t i = 0; i < N; ++i)
+            c[i] = add(c[i], other.c[i]);
+        return *this;
+    }
+
+    constexpr ring_poly &operator-=(ring_poly other)
+    {
+        other.match(transformed);
+        for (size_t i = 0; i < N; ++i)
+            c[i] = sub(c[i], other.c[i]);
+        return *this;
+    }
+
+    // Wynik w dziedzinie NTT.
+    constexpr ring_poly &operator*=(ring_poly other)
+    {
+        to_ntt();
+        other.to_ntt();
+        for (size_t i = 0; i < N; ++i)
+            c[i] = mul(c[i], other.c[i]);
+        return *this;
+    }
+
+    // mnożenie przez stałą nie zmienia dziedziny
+    constexpr ring_poly &operator*=(T k)
+    {
+        k %= Modulus;
+        for (size_t i = 0; i < N; ++i)
+            c[i] = mul(c[i], k);
+        return *this;
+    }
+
+    constexpr ring_poly operator-() const
+    {
+        ring_poly res = *this;
+        for (size_t i = 0; i < N; ++i)
+            res.c[i] = sub(T(0), c[i]);
+        return res;
+    }
+
+    friend constexpr ring_poly operator+(ring_poly a, const ring_poly &b) { return a += b; }
+    friend constexpr ring_poly operator-(ring_poly a, const ring_poly &b) { return a -= b; }
+    friend constexpr ring_poly operator*(ring_poly a, const ring_poly &b) { return a *= b; }
+    friend constexpr ring_poly operator*(ring_poly a, T k) { return a *= k; }
+    friend constexpr ring_poly operator*(T k, ring_poly a) { return a *= k; }
+
+    // NTT jest bijekcją, więc w tej samej dziedzinie porównujemy wprost
+    friend constexpr bool operator==(const ring_poly &a, const ring_poly &b)
+    {
+        if (a.transformed == b.transformed)
+            return a.c == b.c;
+        ring_poly x = a, y = b;
+        x.from_ntt();
+        y.from_ntt();
+        return x.c == y.c;
+    }
+
+private:
+    std::array<T, N> c;
+    bool transformed;
+
+    template <typename U>
+    static constexpr T reduce(U v)
+    {
+        if constexpr (std::is_signed_v<U>)
+        {
+            // |v| modulo, bez przepełnienia dla najmniejszej wartości
+            auto m = static_cast<std::make_unsigned_t<U>>(v < 0 ? -(v + 1) : v) % Modulus;
+            T r = static_cast<T>(m);
+            return v < 0 ? sub(T(0), add(r, 1 % Modulus)) : r;
+        }
+        else
+            return static_cast<T>(v % Modulus);
+    }
+
+    static constexpr T add(T a, T b)
+    {
+        T s = a + b;
+        return s >= Modulus ? s - Modulus : s;
+    }
+
+    static constexpr T sub(T a, T b) { return a >= b ? a - b : a + (Modulus - b); }
+
+    static constexpr T mul(T a, T b) { return detail::mul_mod(a, b, Modulus); }
+
+    constexpr void match(bool ntt)
+    {
+        if (ntt)
+            to_ntt();
+        else
+            from_ntt();
+    }
+
+    // Gentleman-Sande: kolejność naturalna -> odwrócona bitowo
+    constexpr void forward()
+    {
+        const auto &roots = tables::get().roots;
+        for (size_t len = N / 2; len >= 1; len /= 2)
+        {
+            size_t step = N / (2 * len);
+            for (size_t start = 0; start < N; start += 2 * len)
+                for (size_t j = 0; j < len; ++j)
+                {
+                    T u = c[start + j], v = c[start + j + len];
+                    c[start + j] = add(u, v);
+                    c[start + j + len] = mul(sub(u, v), roots[j * step]);
+                }
+        }
+    }
+
+    // Cooley-Tukey: kolejność odwrócona bitowo -> naturalna, bez dzielenia przez N
+    constexpr void inverse()
+    {
+        const auto &roots = tables::get().inv_roots;
+        for (size_t len = 1; len < N; len *= 2)
+        {
+            size_t step = N / (2 * len);
+            for (size_t start = 0; start < N; start += 2 * len)
+                for (size_t j = 0; j < len; ++j)
+                {
+                    T u = c[start + j], v = mul(c[start + j + len], roots[j * step]);
+                    c[start + j] = add(u, v);
+                    c[start + j + len] = sub(u, v);
+                }
+        }
+    }
+};
+
+#endif // RING_POLY_H
@@ -0,0 +1,123 @@
+#include "ring_poly.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+    using u32 = std::uint32_t;
+    using u64 = std::uint64_t;
+
+    std::uint64_t state = 12345;
+
+    std::uint64_t next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 11;
+    }
+
+    template <typename R>
+    R random_ring() {
+        poly<u64, R::size()> p;
+        for (std::size_t i = 0; i < R::size(); ++i)
+            p[i] = next() % R::modulus;
+        return R(p);
+    }
+
+    // iloczyn w Z[x] rozmiaru 2N - 1 i ręczne złożenie - tak jak bez ring_poly
+    template <typename R>
+    void check_against_folding() {
+        constexpr std::size_t n = R::size();
+        constexpr long long q = R::modulus;
+        for (int trial = 0; trial < 5; ++trial) {
+            poly<long long, n> a, b;
+            for (std::size_t i = 0; i < n; ++i) {
+                a[i] = static_cast<long long>(next() % q);
+                b[i] = static_cast<long long>(next() % q);
+            }
+            auto full = a * b;
+            poly<long long, n> folded;
+            for (std::size_t i = 0; i < full.size(); ++i) {
+                long long v = full[i] % q;
+                if (i >= n && R::kind == ring_kind::negacyclic)
+                    folded[i - n] = (folded[i - n] - v + q) % q;
+                else
+                    folded[i % n] = (folded[i % n] + v) % q;
+            }
+
+            poly<typename R::value_type, n> product = (R(a) * R(b)).to_poly();
+            for (std::size_t i = 0; i < n; ++i)
+                assert(static_cast<long long>(product[i]) == folded[i]);
+            // konstruktor z dłuższego wielomianu składa tak samo
+            assert(R(full) == R(a) * R(b));
+        }
+    }
+
+    template <typename R>
+    void check_ring_laws() {
+        R a = random_ring<R>(), b = random_ring<R>(), c = random_ring<R>();
+        assert((a * b) * c == a * (b * c));
+        assert(a * (b + c) == a * b + a * c);
+        assert(a * b == b * a);
+        assert((a - b) + b == a);
+        assert(-a + a == R());
+
+        // x * x^{N-1} = x^N = -1 (albo 1)
+        poly<int, R::size()> x(0, 1), top;
+        top[R::size() - 1] = 1;
+        R expected(poly<int, 1>(R::kind == ring_kind::negacyclic ? -1 : 1));
+        assert(R(x) * R(top) == expected);
+    }
+
+    void test_ntt_domain() {
+        using R = ring_poly<u32, 8, 17>;
+        R a(poly<int, 3>(1, 2, 3)), b(poly<int, 2>(-1, 1));
+
+        R p = a * b;
+        assert(p.in_ntt());
+        // kolejne działania zostają w dziedzinie NTT
+        R s = p + a;
+        assert(s.in_ntt() && !a.in_ntt());
+        R t = p * b;
+        assert(t.in_ntt());
+        assert(s.to_poly()[0] == 0 && s.to_poly()[1] == 1);
+
+        p.from_ntt();
+        assert(!p.in_ntt());
+        // (1 + 2x + 3x^2)(x - 1) = -1 - x - x^2 + 3x^3
+        assert(p[0] == 16 && p[1] == 16 && p[2] == 16 && p[3] == 3 && p[4] == 0);
+        using plain = poly<u32, 8>;
+        assert(static_cast<plain>(p)[3] == 3);
+        assert((2 * a).to_poly()[2] == 6 && (a * 20u).to_poly()[2] == 60 % 17);
+
+        // składanie przy konwersji: x^9 = -x w Z_17[x]/(x^8 + 1)
+        poly<int, 10> high;
+        high[9] = 1;
+        R folded(high);
+        assert(folded[1] == 16);
+        using cyclic = ring_poly<u32, 8, 17, ring_kind::cyclic>;
+        cyclic cyc(high);
+        assert(cyc[1] == 1);
+    }
+
+    // działa też w czasie kompilacji
+    constexpr bool constexpr_square() {
+        using R = ring_poly<u32, 4, 17>;
+        R a(poly<int, 2>(1, 1));
+        auto sq = (a * a * a * a).to_poly();
+        // (1 + x)^4 = 1 + 4x + 6x^2 + 4x^3 + x^4, x^4 = -1
+        return sq[0] == 0 && sq[1] == 4 && sq[2] == 6 && sq[3] == 4;
+    }
+
+    static_assert(constexpr_square());
+    static_assert(detail::is_prime(u64(4179340454199820289ull)) && !detail::is_prime(u64(4179340454199820287ull)));
+}
+
+int main() {
+    test_ntt_domain();
+    check_against_folding<ring_poly<u32, 256, 7681>>();
+    check_against_folding<ring_poly<u32, 64, 7681, ring_kind::cyclic>>();
+    check_against_folding<ring_poly<u32, 1, 7681>>();
+    check_ring_laws<ring_poly<u32, 1024, 12289>>();
+    check_ring_laws<ring_poly<u32, 512, 998244353, ring_kind::cyclic>>();
+    check_ring_laws<ring_poly<u64, 256, 4179340454199820289ull>>();
+    check_ring_laws<ring_poly<u64, 2, 4179340454199820289ull, ring_kind::cyclic>>();
+}
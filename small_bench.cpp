@@ -0,0 +1,116 @@
+// Pomiar rozwiniętych jąder dla małych N (poly_tuning::unroll_limit) względem
+// zwykłych pętli, dla N = 1 .. 16. Kompilacja np.:
+//   g++ -std=c++20 -O2 -march=native small_bench.cpp -o small_bench
+// (z -march=native na procesorach z FMA działa ścieżka std::fma).
+#include "poly.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <utility>
+
+namespace {
+    constexpr std::size_t rounds = 2000000;
+    constexpr std::size_t points = 16;
+    constexpr std::size_t repeats = 5;
+
+    // uniemożliwia kompilatorowi wyliczenie pętli pomiarowej z góry
+    template <typename T>
+    void keep(T& value) {
+        asm volatile("" : "+m"(value));
+    }
+
+    // ścieżka ogólna, tak jak w operator* przed rozwinięciem
+    template <std::size_t N, std::size_t M>
+    poly<double, N + M - 1> generic_product(const poly<double, N>& x, const poly<double, M>& y) {
+        poly<double, N + M - 1> res;
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < M; ++j)
+                res[i + j] = res[i + j] + (x[i] * y[j]);
+        return res;
+    }
+
+    template <std::size_t N>
+    double generic_at(const poly<double, N>& p, double x) {
+        double acc = p[N - 1];
+        for (std::size_t i = N - 1; i-- > 0;)
+            acc = x * acc + p[i];
+        return acc;
+    }
+
+    template <typename F>
+    double seconds(F&& f) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t r = 0; r < rounds; ++r)
+            f();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // najkrótsze z kilku naprzemiennych pomiarów obu wariantów, żeby
+    // kolejność i chwilowe obciążenie maszyny nie faworyzowały żadnego
+    template <typename F, typename G>
+    std::pair<double, double> compare(F&& f, G&& g) {
+        double a = seconds(f), b = seconds(g);
+        for (std::size_t r = 1; r < repeats; ++r) {
+            a = std::min(a, seconds(f));
+            b = std::min(b, seconds(g));
+        }
+        return {a, b};
+    }
+
+    template <std::size_t N>
+    void bench() {
+        poly<double, N> p, q;
+        for (std::size_t i = 0; i < N; ++i) {
+            p[i] = 1.0 + 0.25 * static_cast<double>(i);
+            q[i] = 0.5 - 0.125 * static_cast<double>(i);
+        }
+        // at() liczymy w kilku punktach na rundę: pojedyncze wywołanie dla
+        // N <= 4 trwa ułamek nanosekundy i ginie w narzucie pętli pomiarowej
+        double xs[points];
+        for (std::size_t k = 0; k < points; ++k)
+            xs[k] = 0.5 + 0.03125 * static_cast<double>(k);
+
+        auto [mul_generic, mul_unrolled] = compare(
+            [&] {
+                keep(p);
+                auto r = generic_product(p, q);
+                keep(r);
+            },
+            [&] {
+                keep(p);
+                auto r = p * q;
+                keep(r);
+            });
+        auto [at_generic, at_unrolled] = compare(
+            [&] {
+                keep(xs);
+                for (std::size_t k = 0; k < points; ++k) {
+                    double r = generic_at(p, xs[k]);
+                    keep(r);
+                }
+            },
+            [&] {
+                keep(xs);
+                for (std::size_t k = 0; k < points; ++k) {
+                    double r = p.at(xs[k]);
+                    keep(r);
+                }
+            });
+
+        auto ns = [](double s) { return s * 1e9 / rounds; };
+        std::printf("%2zu  mul %6.2f -> %6.2f ns (x%.2f)   at %6.2f -> %6.2f ns (x%.2f)\n", N,
+                    ns(mul_generic), ns(mul_unrolled), mul_generic / mul_unrolled,
+                    ns(at_generic) / points, ns(at_unrolled) / points, at_generic / at_unrolled);
+    }
+
+    template <std::size_t... I>
+    void bench_all(std::index_sequence<I...>) {
+        (bench<I + 1>(), ...);
+    }
+}
+
+int main() {
+    std::printf(" N  poly<double, N> * poly<double, N> i at(): pętle -> rozwinięte\n");
+    bench_all(std::make_index_sequence<poly_tuning::unroll_limit>());
+}
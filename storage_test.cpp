@@ -0,0 +1,145 @@
+#include "poly.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    template <typename T, std::size_t N, typename S, typename U, typename SU>
+    constexpr bool equal(const poly<T, N, S>& a, const poly<U, N, SU>& b) {
+        for (std::size_t i = 0; i < N; ++i)
+            if (!(a[i] == b[i]))
+                return false;
+        return true;
+    }
+
+    using poly_storage::heap;
+    using poly_storage::arena;
+    using poly_storage::pool;
+    using poly_storage::aligned;
+
+    // dopełnienie za N-tym współczynnikiem musi zostać zerowe
+    template <typename T, std::size_t N>
+    bool zero_tail(const poly<T, N, aligned>& p) {
+        for (std::size_t i = N; i < aligned::padded_size<T, N>; ++i)
+            if (p.data()[i] != T())
+                return false;
+        return true;
+    }
+
+    template <typename T>
+    bool is_aligned(const T* p) {
+        return reinterpret_cast<std::uintptr_t>(p) % aligned::alignment == 0;
+    }
+
+    void test_heap() {
+        static_assert(sizeof(poly<double, 1 << 20, heap>) == sizeof(void*));
+        static_assert(std::is_same_v<decltype(poly<int, 2, heap>() * poly<int, 3>()), poly<int, 4, heap>>);
+        static_assert(std::is_same_v<decltype(poly<int, 2>() + poly<double, 3, heap>()), poly<double, 3, heap>>);
+
+        // bufor na stercie działa też w czasie kompilacji
+        static_assert((poly<int, 3, heap>(1, 2, 3) * poly<int, 2, heap>(1, 1))[1] == 3);
+
+        poly<double, 1 << 20, heap> big;
+        big[0] = 1.0;
+        big[(1 << 20) - 1] = 2.0;
+        const double* before = big.data();
+        auto moved = std::move(big);
+        assert(moved.data() == before);
+        assert(moved[(1 << 20) - 1] == 2.0);
+
+        // przeniesiony obiekt można ponownie przypisać
+        big = moved;
+        assert(big[0] == 1.0);
+        big = poly<int, 2>(5, 6);
+        assert(big[1] == 6.0 && big[(1 << 20) - 1] == 0.0);
+
+        poly<poly<int, 2, heap>, 3, heap> nested(poly<int, 2, heap>(1, 2), 3, 4);
+        auto nested_sq = nested * nested;
+        assert(equal(nested_sq[0], poly<int, 3>(1, 4, 4)));
+        assert(equal(nested_sq[2], poly<int, 3>(17, 16, 0)));
+        assert(nested.at(2, 1) == 3 + 2 * 3 + 4 * 4);
+
+        poly<long long, 4> inline_copy(nested[0]);
+        assert(equal(inline_copy, poly<long long, 4>(1, 2)));
+    }
+
+    void test_arena() {
+        poly_arena batch(1 << 12);
+        {
+            poly_arena::scope active(batch);
+            poly<double, 100, arena> p(1.0, 2.0);
+            poly<double, 100, arena> q(3.0, 4.0);
+            for (int i = 0; i < 100; ++i) {
+                auto r = p * q + p;
+                assert(r[0] == 4.0 && r[1] == 12.0 && r[2] == 8.0);
+            }
+            auto kept = std::move(q);
+            assert(kept[1] == 4.0);
+            batch.reset();
+        }
+
+        // bez aktywnej areny bufor trafia na stertę
+        poly<int, 3, arena> outside(1, 2, 3);
+        assert(outside.at(2) == 17);
+    }
+
+    void test_aligned() {
+        static_assert(aligned::padded_size<float, 7> == 16);
+        static_assert(aligned::padded_size<double, 8> == 8);
+        static_assert(aligned::padded_size<double, 9> == 16);
+        static_assert(aligned::padded_size<char, 1> == 64);
+        static_assert(alignof(poly<float, 7, aligned>) == 64 && sizeof(poly<float, 7, aligned>) == 64);
+        static_assert(sizeof(poly<poly<float, 7, aligned>, 5, aligned>) == 5 * 64);
+        static_assert(poly<float, 7, aligned>().size() == 7);
+        static_assert(std::is_same_v<decltype(poly<int, 3, aligned>() * poly<int, 2>()), poly<int, 4, aligned>>);
+        static_assert((poly<int, 3, aligned>(1, 2, 3) + poly<int, 3, aligned>(3, 2, 1))[2] == 4);
+
+        poly<float, 7, aligned> p(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        poly<float, 7, aligned> q(7.0f, 6.0f, 5.0f);
+        auto sum = p + q;
+        auto diff = p - q;
+        auto neg = -p;
+        auto prod = p * q;
+        auto scaled = p * 2.0f;
+        poly<float, 7, aligned> small(1.0f, 1.0f);
+        poly<float, 7, aligned> assigned;
+        assigned = poly<float, 3>(1.0f, 2.0f, 3.0f);
+        assigned += p;
+        assert(sum[0] == 8.0f && sum[6] == 7.0f && diff[2] == -2.0f && diff[6] == 7.0f);
+        assert(prod[12] == 0.0f && prod[2] == 5.0f + 12.0f + 21.0f && scaled[6] == 14.0f);
+        assert(assigned[2] == 6.0f && small.at(2.0f) == 3.0f);
+        assert(zero_tail(p) && zero_tail(q) && zero_tail(sum) && zero_tail(diff) && zero_tail(neg));
+        assert(zero_tail(prod) && zero_tail(scaled) && zero_tail(assigned));
+
+        // zagnieżdżone wiersze zaczynają się na granicy linii
+        poly<poly<float, 7, aligned>, 5, aligned> rows(p, q, sum);
+        for (std::size_t i = 0; i < rows.size(); ++i)
+            assert(is_aligned(rows[i].data()) && zero_tail(rows[i]));
+        auto row_sum = rows + rows;
+        assert(row_sum[1][0] == 14.0f && zero_tail(row_sum[4]));
+
+        poly<double, 9, aligned>* boxed = new poly<double, 9, aligned>(1.0, 2.0);
+        assert(is_aligned(boxed->data()) && zero_tail(*boxed));
+        delete boxed;
+    }
+
+    void test_pool() {
+        poly<int, 8, pool> p(1, 1);
+        for (int i = 0; i < 1000; ++i) {
+            poly<int, 8, pool> q = p;
+            q += p;
+            assert(q[1] == 2);
+        }
+        poly<int, 15, pool> sq = p * p;
+        assert(equal(sq, poly<int, 15>(1, 2, 1)));
+    }
+}
+
+int main() {
+    test_heap();
+    test_arena();
+    test_pool();
+    test_aligned();
+}